@@ -72,21 +72,23 @@ void streamfx::configuration::save()
 {
 	std::lock_guard<std::mutex> lg(_task_lock);
 	if (!_save_task || _save_task->is_completed()) {
-		_save_task = streamfx::threadpool()->push([this](streamfx::util::threadpool::task_data_t) {
-			// ToDo: Implement delayed tasks in ::threadpool.
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-			// Update version tag.
-			obs_data_set_int(_data.get(), version_tag_name.data(), STREAMFX_VERSION);
-
-			if (_config_path.has_parent_path()) {
-				std::filesystem::create_directories(_config_path.parent_path());
-			}
-			if (!obs_data_save_json_safe(_data.get(), _config_path.u8string().c_str(), ".tmp",
-										 path_backup_ext.data())) {
-				D_LOG_ERROR("Failed to save configuration file.", nullptr);
-			}
-		});
+		_save_task = streamfx::threadpool()->push(
+			[this](streamfx::util::threadpool::task_data_t) {
+				// ToDo: Implement delayed tasks in ::threadpool.
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+				// Update version tag.
+				obs_data_set_int(_data.get(), version_tag_name.data(), STREAMFX_VERSION);
+
+				if (_config_path.has_parent_path()) {
+					std::filesystem::create_directories(_config_path.parent_path());
+				}
+				if (!obs_data_save_json_safe(_data.get(), _config_path.u8string().c_str(), ".tmp",
+											 path_backup_ext.data())) {
+					D_LOG_ERROR("Failed to save configuration file.", nullptr);
+				}
+			},
+			nullptr, streamfx::util::threadpool::priority::BACKGROUND);
 	}
 }
 
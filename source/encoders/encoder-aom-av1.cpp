@@ -23,6 +23,8 @@
 //--------------------------------------------------------------------------------//
 
 #include "encoder-aom-av1.hpp"
+#include "plugin.hpp"
+#include "statistics.hpp"
 #include "util/util-logging.hpp"
 
 #include "warning-disable.hpp"
@@ -36,12 +38,14 @@
 #define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
 #define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
 #define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_ERROR_LIMITED(x, ...) P_LOG_ERROR_LIMITED(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
 #else
 #define ST_PREFIX "<encoder::aom::av1> "
 #define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
 #define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
 #define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
 #define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#define D_LOG_ERROR_LIMITED(...) P_LOG_ERROR_LIMITED(ST_PREFIX __VA_ARGS__)
 #endif
 
 #define ST_I18N "Encoder.AOM.AV1"
@@ -327,9 +331,9 @@ aom_av1_instance::aom_av1_instance(obs_data_t* settings, obs_encoder_t* self, bo
 
 #ifdef ENABLE_PROFILING
 	// Profilers
-	_profiler_copy   = streamfx::util::profiler::create();
-	_profiler_encode = streamfx::util::profiler::create();
-	_profiler_packet = streamfx::util::profiler::create();
+	_profiler_copy   = streamfx::util::profiler::create("AOM Copy");
+	_profiler_encode = streamfx::util::profiler::create("AOM Encode");
+	_profiler_packet = streamfx::util::profiler::create("AOM Packet");
 #endif
 
 	{     // Generate Static Configuration
@@ -1062,6 +1066,18 @@ void aom_av1_instance::get_video_info(struct video_scale_info* info)
 	}
 }
 
+void aom_av1_instance::statistics(obs_data_t* data)
+{
+	obs_data_set_int(data, "lookahead", _settings.rc_lookahead);
+	obs_data_set_int(data, "threads", _settings.threads);
+
+#ifdef ENABLE_PROFILING
+	streamfx::statistics::write_profiler(data, "copy", _profiler_copy);
+	streamfx::statistics::write_profiler(data, "encode", _profiler_encode);
+	streamfx::statistics::write_profiler(data, "packet", _profiler_packet);
+#endif
+}
+
 bool streamfx::encoder::aom::av1::aom_av1_instance::encode_video(encoder_frame* frame, encoder_packet* packet,
 																 bool* received_packet)
 {
@@ -1072,13 +1088,17 @@ bool streamfx::encoder::aom::av1::aom_av1_instance::encode_video(encoder_frame*
 #ifdef ENABLE_PROFILING
 		auto profile = _profiler_copy->track();
 #endif
-		std::memcpy(image.planes[AOM_PLANE_Y], frame->data[0], frame->linesize[0] * image.h);
-		if (image.fmt == AOM_IMG_FMT_I420) {
-			std::memcpy(image.planes[AOM_PLANE_U], frame->data[1], frame->linesize[1] * image.h / 2);
-			std::memcpy(image.planes[AOM_PLANE_V], frame->data[2], frame->linesize[2] * image.h / 2);
-		} else {
-			std::memcpy(image.planes[AOM_PLANE_U], frame->data[1], frame->linesize[1] * image.h);
-			std::memcpy(image.planes[AOM_PLANE_V], frame->data[2], frame->linesize[2] * image.h);
+		size_t chroma_h = (image.fmt == AOM_IMG_FMT_I420) ? (image.h / 2) : image.h;
+		for (size_t plane = AOM_PLANE_Y; plane <= AOM_PLANE_V; plane++) {
+			uint8_t*       to     = image.planes[plane];
+			const uint8_t* from   = frame->data[plane];
+			size_t         stride = static_cast<size_t>(frame->linesize[plane]);
+			size_t         rows   = (plane == AOM_PLANE_Y) ? image.h : chroma_h;
+
+			// Split the copy into row ranges, so that it scales with the number of cores.
+			streamfx::threadpool()->parallel_for(rows, 64, [=](size_t begin, size_t end) {
+				std::memcpy(to + begin * stride, from + begin * stride, stride * (end - begin));
+			});
 		}
 	}
 
@@ -1092,8 +1112,8 @@ bool streamfx::encoder::aom::av1::aom_av1_instance::encode_video(encoder_frame*
 		}
 		if (auto error = _factory->libaom_codec_encode(&_ctx, &image, frame->pts, 1, flags); error != AOM_CODEC_OK) {
 			const char* errstr = _factory->libaom_codec_err_to_string(error);
-			D_LOG_ERROR("Encoding frame failed with error: %s (code %" PRIu32 ")\n%s\n%s", errstr, error,
-						_factory->libaom_codec_error(&_ctx), _factory->libaom_codec_error_detail(&_ctx));
+			D_LOG_ERROR_LIMITED("Encoding frame failed with error: %s (code %" PRIu32 ")\n%s\n%s", errstr, error,
+								_factory->libaom_codec_error(&_ctx), _factory->libaom_codec_error_detail(&_ctx));
 			return false;
 		} else {
 			// Increment the image index.
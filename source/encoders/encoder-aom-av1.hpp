@@ -124,6 +124,8 @@ namespace streamfx::encoder::aom::av1 {
 
 		virtual void get_video_info(struct video_scale_info* info);
 
+		virtual void statistics(obs_data_t* data);
+
 		virtual bool encode_video(encoder_frame* frame, encoder_packet* packet, bool* received_packet);
 	};
 
@@ -22,10 +22,12 @@
 #include "encoder-ffmpeg.hpp"
 #include "strings.hpp"
 #include "codecs/hevc.hpp"
+#include "ffmpeg/conversion-cache.hpp"
 #include "ffmpeg/tools.hpp"
 #include "handlers/debug_handler.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "plugin.hpp"
+#include "util/util-logging.hpp"
 
 #include "warning-disable.hpp"
 #include <sstream>
@@ -78,6 +80,8 @@ extern "C" {
 #define ST_KEY_FFMPEG_FRAMERATE "FFmpeg.Framerate"
 #define ST_I18N_FFMPEG_GPU ST_I18N_FFMPEG ".GPU"
 #define ST_KEY_FFMPEG_GPU "FFmpeg.GPU"
+#define ST_I18N_FFMPEG_PIPELINED ST_I18N_FFMPEG ".Pipelined"
+#define ST_KEY_FFMPEG_PIPELINED "FFmpeg.Pipelined"
 
 #define ST_I18N_KEYFRAMES ST_I18N_FFMPEG ".KeyFrames"
 #define ST_I18N_KEYFRAMES_INTERVALTYPE ST_I18N_KEYFRAMES ".IntervalType"
@@ -92,6 +96,9 @@ using namespace streamfx::encoder::codec;
 
 enum class keyframe_type { SECONDS, FRAMES };
 
+// Maximum number of frames waiting for the encode thread before new frames are skipped.
+static constexpr size_t pipeline_depth = 4;
+
 ffmpeg_instance::ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool is_hw)
 	: encoder_instance(settings, self, is_hw),
 
@@ -105,7 +112,10 @@ ffmpeg_instance::ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool
 
 	  _lag_in_frames(0), _sent_frames(0), _have_first_frame(false), _extra_data(), _sei_data(),
 
-	  _free_frames(), _used_frames(), _free_frames_last_used()
+	  _free_frames(), _used_frames(), _used_frames_count(0), _conversion_consumer(),
+
+	  _pipelined(false), _encode_thread(), _encode_lock(), _encode_cv(), _encode_done_cv(), _encode_frames(),
+	  _encode_packets(), _encode_shutdown(false), _encode_failed(false), _zero_copy(false)
 {
 	// Initialize GPU Stuff
 	if (is_hw) {
@@ -164,10 +174,39 @@ ffmpeg_instance::ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool
 	if (res < 0) {
 		throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
 	}
+
+	// Software frames come from the pool shared by every encoder, so that identical encoders share their buffers.
+	if (!_hwinst) {
+		_free_frames = ::streamfx::ffmpeg::avframe_pool::find(_context->width, _context->height, _context->pix_fmt);
+		if (auto cache = ::streamfx::ffmpeg::conversion_cache::instance(); cache) {
+			_conversion_consumer = cache->attach(obs_encoder_video(_self));
+		}
+	}
+
+	// Encode on a separate thread if requested, so that OBS Studio only has to hand over frames.
+	_pipelined = obs_data_get_bool(settings, ST_KEY_FFMPEG_PIPELINED);
+	if (_pipelined) {
+		_encode_thread = std::thread([this]() { encode_thread(); });
+	}
+
+	// Frames from OBS Studio are only valid during the call, so they can only be handed over as is if the encoder has
+	// no lag, and is done with them once avcodec_send_frame returns. Delayed, frame threaded and pipelined encoding
+	// keep frames around, which for example leaves ProRes and DNxHD with a single thread on this path.
+	_zero_copy = !_hwinst && !_pipelined && ((_codec->capabilities & AV_CODEC_CAP_DELAY) == 0)
+				 && ((_context->active_thread_type & FF_THREAD_FRAME) == 0);
 }
 
 ffmpeg_instance::~ffmpeg_instance()
 {
+	if (_encode_thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(_encode_lock);
+			_encode_shutdown = true;
+		}
+		_encode_cv.notify_all();
+		_encode_thread.join();
+	}
+
 	auto gctx = streamfx::obs::gs::context();
 	if (_context) {
 		// Flush encoders that require it.
@@ -199,6 +238,7 @@ void ffmpeg_instance::get_properties(obs_properties_t* props)
 
 	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_THREADS), false);
 	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_GPU), false);
+	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_PIPELINED), false);
 }
 
 void ffmpeg_instance::migrate(obs_data_t* settings, uint64_t version)
@@ -218,6 +258,13 @@ bool ffmpeg_instance::update(obs_data_t* settings)
 														  support_reconfig_keyframes);
 	}
 
+	// The encode thread uses the context without holding the lock, so it has to be idle while the context changes.
+	std::unique_lock<std::mutex> ul(_encode_lock, std::defer_lock);
+	if (_pipelined) {
+		ul.lock();
+		_encode_done_cv.wait(ul, [this]() { return _encode_frames.empty(); });
+	}
+
 	if (!_context->internal) {
 		// FFmpeg Options
 		_context->debug                 = 0;
@@ -235,7 +282,7 @@ bool ffmpeg_instance::update(obs_data_t* settings)
 				_context->thread_type |= FF_THREAD_SLICE;
 			}
 			if (_context->thread_type != 0) {
-				int64_t threads = obs_data_get_int(settings, ST_I18N_FFMPEG_THREADS);
+				int64_t threads = obs_data_get_int(settings, ST_KEY_FFMPEG_THREADS);
 				if (threads > 0) {
 					_context->thread_count = static_cast<int>(threads);
 				} else {
@@ -361,23 +408,22 @@ static inline void copy_data(encoder_frame* frame, AVFrame* vframe)
 			continue;
 
 		std::size_t plane_height = static_cast<size_t>(vframe->height) >> (idx ? v_chroma_shift : 0);
-
-		if (static_cast<uint32_t>(vframe->linesize[idx]) == frame->linesize[idx]) {
-			std::memcpy(vframe->data[idx], frame->data[idx], frame->linesize[idx] * plane_height);
-		} else {
-			std::size_t ls_in  = static_cast<size_t>(frame->linesize[idx]);
-			std::size_t ls_out = static_cast<size_t>(vframe->linesize[idx]);
-			std::size_t bytes  = ls_in < ls_out ? ls_in : ls_out;
-
-			uint8_t* to   = vframe->data[idx];
-			uint8_t* from = frame->data[idx];
-
-			for (std::size_t y = 0; y < plane_height; y++) {
-				std::memcpy(to, from, bytes);
-				to += ls_out;
-				from += ls_in;
+		std::size_t ls_in        = static_cast<size_t>(frame->linesize[idx]);
+		std::size_t ls_out       = static_cast<size_t>(vframe->linesize[idx]);
+		std::size_t bytes        = ls_in < ls_out ? ls_in : ls_out;
+		uint8_t*    to           = vframe->data[idx];
+		uint8_t*    from         = frame->data[idx];
+
+		// A single thread can't saturate memory bandwidth, so split large planes into row ranges.
+		streamfx::threadpool()->parallel_for(plane_height, 64, [=](std::size_t begin, std::size_t end) {
+			if (ls_in == ls_out) {
+				std::memcpy(to + begin * ls_out, from + begin * ls_in, ls_in * (end - begin));
+			} else {
+				for (std::size_t y = begin; y < end; y++) {
+					std::memcpy(to + y * ls_out, from + y * ls_in, bytes);
+				}
 			}
-		}
+		});
 	}
 }
 
@@ -392,7 +438,41 @@ bool ffmpeg_instance::encode_video(struct encoder_frame* frame, struct encoder_p
 		return true;
 	}
 
-	std::shared_ptr<AVFrame> vframe = pop_free_frame(); // Retrieve an empty frame.
+	bool is_copy = (_scaler.is_source_full_range() == _scaler.is_target_full_range())
+				   && (_scaler.get_source_colorspace() == _scaler.get_target_colorspace())
+				   && (_scaler.get_source_format() == _scaler.get_target_format());
+
+	// Hand the frame over as is if possible.
+	std::shared_ptr<AVFrame> vframe;
+	if (is_copy && _zero_copy) {
+		vframe = wrap_frame(frame);
+	}
+	bool is_wrapped = (vframe != nullptr);
+
+	// Another encoder of the same video output may already have converted this frame to the same target.
+	auto                                        cache = ::streamfx::ffmpeg::conversion_cache::instance();
+	::streamfx::ffmpeg::conversion_cache::key_t key;
+	bool                                        is_shared = false;
+	if (!is_wrapped && cache) {
+		video_t* video = obs_encoder_video(_self);
+		key            = {video,
+						  video_output_get_total_frames(video),
+						  frame->data[0],
+						  _scaler.get_source_format(),
+						  _scaler.is_source_full_range(),
+						  _scaler.get_source_colorspace(),
+						  _scaler.get_target_width(),
+						  _scaler.get_target_height(),
+						  _scaler.get_target_format(),
+						  _scaler.is_target_full_range(),
+						  _scaler.get_target_colorspace()};
+		vframe    = cache->find(key);
+		is_shared = (vframe != nullptr);
+	}
+
+	if (!vframe) {
+		vframe = pop_free_frame();
+	}
 
 	// Convert frame.
 	{
@@ -404,24 +484,34 @@ bool ffmpeg_instance::encode_video(struct encoder_frame* frame, struct encoder_p
 		vframe->color_trc       = _context->color_trc;
 		vframe->pts             = frame->pts;
 
-		if ((_scaler.is_source_full_range() == _scaler.is_target_full_range())
-			&& (_scaler.get_source_colorspace() == _scaler.get_target_colorspace())
-			&& (_scaler.get_source_format() == _scaler.get_target_format())) {
+		if (is_wrapped || is_shared) {
+			// Nothing to do, the frame already points at the data.
+		} else if (is_copy) {
 			copy_data(frame, vframe.get());
 		} else {
 			int res = _scaler.convert(reinterpret_cast<uint8_t**>(frame->data), reinterpret_cast<int*>(frame->linesize),
 									  0, _context->height, vframe->data, vframe->linesize);
 			if (res <= 0) {
-				DLOG_ERROR("Failed to convert frame: %s (%" PRId32 ").",
-						   ::streamfx::ffmpeg::tools::get_error_description(res), res);
+				P_LOG_ERROR_LIMITED("Failed to convert frame: %s (%" PRId32 ").",
+									::streamfx::ffmpeg::tools::get_error_description(res), res);
 				return false;
 			}
 		}
+
+		if (!is_wrapped && !is_shared && cache) {
+			cache->insert(key, vframe);
+		}
 	}
 
 	if (!encode_avframe(vframe, packet, received_packet))
 		return false;
 
+	// An encoder that still references the frame would read freed memory later, so stop wrapping frames for it.
+	if (is_wrapped && (av_buffer_get_ref_count(vframe->buf[0]) > 1)) {
+		DLOG_WARNING("Encoder '%s' kept a frame past the call, falling back to copying frames.", _codec->name);
+		_zero_copy = false;
+	}
+
 	return true;
 }
 
@@ -546,61 +636,102 @@ void ffmpeg_instance::initialize_hw(obs_data_t*)
 #endif
 }
 
-void ffmpeg_instance::push_free_frame(std::shared_ptr<AVFrame> frame)
-{
-	auto now = std::chrono::high_resolution_clock::now();
-	if (_free_frames.size() > 0) {
-		if ((now - _free_frames_last_used) < std::chrono::seconds(1)) {
-			_free_frames.push(frame);
-		}
-	} else {
-		_free_frames.push(frame);
-		_free_frames_last_used = std::chrono::high_resolution_clock::now();
-	}
-}
-
 std::shared_ptr<AVFrame> ffmpeg_instance::pop_free_frame()
 {
-	std::shared_ptr<AVFrame> frame;
-	if (_free_frames.size() > 0) {
-		// Re-use existing frames first.
-		frame = _free_frames.top();
-		_free_frames.pop();
-	} else {
-		if (_hwinst) {
-			frame = _hwinst->allocate_frame(_context->hw_frames_ctx);
-		} else {
-			frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame* frame) {
-				av_frame_unref(frame);
-				av_frame_free(&frame);
-			});
-
-			frame->width  = _context->width;
-			frame->height = _context->height;
-			frame->format = _context->pix_fmt;
-
-			int res = av_frame_get_buffer(frame.get(), 32);
-			if (res < 0) {
-				throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
-			}
-		}
+	// Hardware frames are recycled by the hardware frame pool of the context.
+	if (_hwinst) {
+		return _hwinst->allocate_frame(_context->hw_frames_ctx);
 	}
 
-	return frame;
+	// Frames return to the shared pool once the last reference to them is released.
+	return _free_frames->acquire();
 }
 
 void ffmpeg_instance::push_used_frame(std::shared_ptr<AVFrame> frame)
 {
 	_used_frames.push(frame);
+	_used_frames_count = _used_frames.size();
 }
 
 std::shared_ptr<AVFrame> ffmpeg_instance::pop_used_frame()
 {
+	if (_used_frames.empty()) {
+		return nullptr;
+	}
+
 	auto frame = _used_frames.front();
 	_used_frames.pop();
+	_used_frames_count = _used_frames.size();
 	return frame;
 }
 
+std::shared_ptr<AVFrame> ffmpeg_instance::wrap_frame(struct encoder_frame* frame)
+{
+	auto desc   = av_pix_fmt_desc_get(_context->pix_fmt);
+	int  planes = av_pix_fmt_count_planes(_context->pix_fmt);
+	if (!desc || (planes <= 0) || (planes > MAX_AV_PLANES)) {
+		return nullptr;
+	}
+
+	// Only wrap planes that satisfy the same alignment as the frames allocated by the frame pool.
+	for (int idx = 0; idx < planes; idx++) {
+		if (!frame->data[idx] || (frame->linesize[idx] == 0) || ((frame->linesize[idx] % 32) != 0)
+			|| ((reinterpret_cast<uintptr_t>(frame->data[idx]) % 32) != 0)) {
+			return nullptr;
+		}
+	}
+
+	std::shared_ptr<AVFrame> vframe{av_frame_alloc(), [](AVFrame* ptr) { av_frame_free(&ptr); }};
+	if (!vframe) {
+		return nullptr;
+	}
+	vframe->width  = _context->width;
+	vframe->height = _context->height;
+	vframe->format = _context->pix_fmt;
+
+	for (int idx = 0; idx < planes; idx++) {
+		int    shift        = ((idx == 1) || (idx == 2)) ? desc->log2_chroma_h : 0;
+		size_t plane_height = static_cast<size_t>(AV_CEIL_RSHIFT(_context->height, shift));
+		size_t plane_size   = static_cast<size_t>(frame->linesize[idx]) * plane_height;
+
+		// OBS Studio owns the memory, so releasing the buffer must not free it.
+		vframe->buf[idx] =
+			av_buffer_create(frame->data[idx], plane_size, [](void*, uint8_t*) {}, nullptr, AV_BUFFER_FLAG_READONLY);
+		if (!vframe->buf[idx]) {
+			return nullptr;
+		}
+
+		vframe->data[idx]     = frame->data[idx];
+		vframe->linesize[idx] = static_cast<int>(frame->linesize[idx]);
+	}
+
+	return vframe;
+}
+
+void ffmpeg_instance::statistics(obs_data_t* data)
+{
+	size_t used_frames = _used_frames_count.load();
+
+	obs_data_set_string(data, "codec", _codec->name);
+	obs_data_set_bool(data, "hardware", is_hardware_encode());
+	// Frames sent to the encoder that have not yet come back as a packet.
+	obs_data_set_int(data, "lag_frames", static_cast<long long>(used_frames));
+	obs_data_set_bool(data, "pipelined", _pipelined);
+	obs_data_set_bool(data, "zero_copy", _zero_copy);
+	if (_pipelined) {
+		std::lock_guard<std::mutex> lock(_encode_lock);
+		obs_data_set_int(data, "queued_frames", static_cast<long long>(_encode_frames.size()));
+		obs_data_set_int(data, "queued_packets", static_cast<long long>(_encode_packets.size()));
+	}
+
+	// Only software frames have a known size, hardware frames live in the hardware frame pool.
+	if (_free_frames) {
+		// Pooled frames are shared with every other encoder using the same size and format.
+		obs_data_set_int(data, "pooled_frames", static_cast<long long>(_free_frames->pooled()));
+		obs_data_set_int(data, "frame_memory", static_cast<long long>(_free_frames->frame_size() * used_frames));
+	}
+}
+
 bool ffmpeg_instance::get_extra_data(uint8_t** data, size_t* size)
 {
 	if (!_have_first_frame)
@@ -636,13 +767,21 @@ int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet
 	av_packet_unref(_packet.get());
 
 	{
-		auto gctx = streamfx::obs::gs::context();
+		// Only hardware frames need the graphics context, a software encoder must not hold up rendering.
+		auto gctx = _hwinst ? std::make_unique<streamfx::obs::gs::context>() : nullptr;
 		res       = avcodec_receive_packet(_context, _packet.get());
 	}
 	if (res != 0) {
 		return res;
 	}
 
+	process_packet(received_packet, packet);
+
+	return res;
+}
+
+void ffmpeg_instance::process_packet(bool* received_packet, struct encoder_packet* packet)
+{
 	if (!_have_first_frame) {
 		if (_codec->id == AV_CODEC_ID_H264) {
 			uint8_t*    tmp_packet;
@@ -741,17 +880,21 @@ int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet
 		}
 	}
 
-	// Push free frame back into pool.
-	push_free_frame(pop_used_frame());
-
-	return res;
+	// The oldest frame is done, which returns it to the pool. The encode thread drops frames from the same queue.
+	if (_pipelined) {
+		std::lock_guard<std::mutex> lock(_encode_lock);
+		pop_used_frame();
+	} else {
+		pop_used_frame();
+	}
 }
 
 int ffmpeg_instance::send_frame(std::shared_ptr<AVFrame> const frame)
 {
 	int res = 0;
 	{
-		auto gctx = streamfx::obs::gs::context();
+		// Only hardware frames need the graphics context, a software encoder must not hold up rendering.
+		auto gctx = _hwinst ? std::make_unique<streamfx::obs::gs::context>() : nullptr;
 		res       = avcodec_send_frame(_context, frame.get());
 	}
 	if (res == 0) {
@@ -763,6 +906,10 @@ int ffmpeg_instance::send_frame(std::shared_ptr<AVFrame> const frame)
 
 bool ffmpeg_instance::encode_avframe(std::shared_ptr<AVFrame> frame, encoder_packet* packet, bool* received_packet)
 {
+	if (_pipelined) {
+		return encode_avframe_pipelined(frame, packet, received_packet);
+	}
+
 	bool sent_frame  = false;
 	bool recv_packet = false;
 	bool should_lag  = (_sent_frames >= _lag_in_frames);
@@ -784,18 +931,18 @@ bool ffmpeg_instance::encode_avframe(std::shared_ptr<AVFrame> frame, encoder_pac
 				// This means we should call receive_packet again, but what do we do with that data?
 				// Why can't we queue on both? Do I really have to implement threading for this stuff?
 				if (*received_packet == true) {
-					DLOG_WARNING("Skipped frame due to EAGAIN when a packet was already returned.");
+					P_LOG_WARN_LIMITED("Skipped frame due to EAGAIN when a packet was already returned.");
 					sent_frame = true;
 				}
 				eagain_is_stupid = true;
 				break;
 			case AVERROR(EOF):
-				DLOG_ERROR("Skipped frame due to end of stream.");
+				P_LOG_ERROR_LIMITED("Skipped frame due to end of stream.");
 				sent_frame = true;
 				break;
 			default:
-				DLOG_ERROR("Failed to encode frame: %s (%" PRId32 ").",
-						   ::streamfx::ffmpeg::tools::get_error_description(res), res);
+				P_LOG_ERROR_LIMITED("Failed to encode frame: %s (%" PRId32 ").",
+									::streamfx::ffmpeg::tools::get_error_description(res), res);
 				return false;
 			}
 		}
@@ -807,7 +954,7 @@ bool ffmpeg_instance::encode_avframe(std::shared_ptr<AVFrame> frame, encoder_pac
 				recv_packet = true;
 				break;
 			case AVERROR(EOF):
-				DLOG_ERROR("Received end of file.");
+				P_LOG_ERROR_LIMITED("Received end of file.");
 				recv_packet = true;
 				break;
 			case AVERROR(EAGAIN):
@@ -815,13 +962,13 @@ bool ffmpeg_instance::encode_avframe(std::shared_ptr<AVFrame> frame, encoder_pac
 					recv_packet = true;
 				}
 				if (eagain_is_stupid) {
-					DLOG_ERROR("Both send and recieve returned EAGAIN, encoder is broken.");
+					P_LOG_ERROR_LIMITED("Both send and recieve returned EAGAIN, encoder is broken.");
 					return false;
 				}
 				break;
 			default:
-				DLOG_ERROR("Failed to receive packet: %s (%" PRId32 ").",
-						   ::streamfx::ffmpeg::tools::get_error_description(res), res);
+				P_LOG_ERROR_LIMITED("Failed to receive packet: %s (%" PRId32 ").",
+									::streamfx::ffmpeg::tools::get_error_description(res), res);
 				return false;
 			}
 		}
@@ -831,12 +978,117 @@ bool ffmpeg_instance::encode_avframe(std::shared_ptr<AVFrame> frame, encoder_pac
 		}
 	}
 
-	if (!sent_frame)
-		push_free_frame(frame);
+	return true;
+}
+
+bool ffmpeg_instance::encode_avframe_pipelined(std::shared_ptr<AVFrame> frame, encoder_packet* packet,
+											   bool* received_packet)
+{
+	bool should_lag = (_sent_frames >= _lag_in_frames);
+	auto loop_end   = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(50);
+
+	std::shared_ptr<AVPacket> ready;
+	{
+		std::unique_lock<std::mutex> ul(_encode_lock);
+
+		// Hand the frame over to the encode thread, unless it is too far behind.
+		auto has_room = [this]() { return _encode_failed || (_encode_frames.size() < pipeline_depth); };
+		if (_encode_done_cv.wait_until(ul, loop_end, has_room)) {
+			_encode_frames.push(frame);
+			push_used_frame(frame);
+			_encode_cv.notify_one();
+		} else {
+			P_LOG_WARN_LIMITED("Skipped frame due to the encode thread falling behind.");
+		}
+
+		// Only wait for a packet once the pipeline is full, otherwise return whatever is ready.
+		if (should_lag && (_encode_frames.size() >= pipeline_depth)) {
+			_encode_done_cv.wait_until(ul, loop_end, [this]() { return _encode_failed || !_encode_packets.empty(); });
+		}
+
+		if (_encode_failed) {
+			return false;
+		}
+
+		if (!_encode_packets.empty()) {
+			ready = _encode_packets.front();
+			_encode_packets.pop();
+		}
+	}
+
+	if (ready) {
+		// The packet data has to remain valid until the next call, so keep it as the current packet.
+		_packet = ready;
+		process_packet(received_packet, packet);
+	}
 
 	return true;
 }
 
+void ffmpeg_instance::encode_thread()
+{
+	std::unique_lock<std::mutex> ul(_encode_lock);
+	while (!_encode_shutdown) {
+		if (_encode_frames.empty()) {
+			_encode_cv.wait(ul, [this]() { return _encode_shutdown || !_encode_frames.empty(); });
+			continue;
+		}
+
+		auto frame = _encode_frames.front();
+		ul.unlock();
+
+		int  res         = 0;
+		bool recv_packet = false;
+		{
+			// Only hardware frames need the graphics context, a software encoder must not hold up rendering.
+			auto gctx = _hwinst ? std::make_unique<streamfx::obs::gs::context>() : nullptr;
+			res       = avcodec_send_frame(_context, frame.get());
+
+			// Collect everything the encoder has ready, which also makes room for the frame if it was refused.
+			while (true) {
+				std::shared_ptr<AVPacket> ready{av_packet_alloc(), [](AVPacket* ptr) { av_packet_free(&ptr); }};
+				if (avcodec_receive_packet(_context, ready.get()) != 0) {
+					break;
+				}
+
+				std::lock_guard<std::mutex> lock(_encode_lock);
+				_encode_packets.push(ready);
+				_encode_done_cv.notify_all();
+				recv_packet = true;
+			}
+		}
+
+		ul.lock();
+		if ((res == AVERROR(EAGAIN)) && recv_packet) {
+			// The encoder has room again, so try the same frame once more.
+			continue;
+		}
+
+		_encode_frames.pop();
+		if (res != 0) {
+			// The frame will never come back as a packet.
+			pop_used_frame();
+		}
+		switch (res) {
+		case 0:
+			break;
+		case AVERROR(EOF):
+			P_LOG_ERROR_LIMITED("Skipped frame due to end of stream.");
+			break;
+		case AVERROR(EAGAIN):
+			P_LOG_ERROR_LIMITED("Both send and recieve returned EAGAIN, encoder is broken.");
+			_encode_failed = true;
+			break;
+		default:
+			P_LOG_ERROR_LIMITED("Failed to encode frame: %s (%" PRId32 ").",
+								::streamfx::ffmpeg::tools::get_error_description(res), res);
+			_encode_failed = true;
+			break;
+		}
+		_encode_done_cv.notify_all();
+	}
+}
+
 bool ffmpeg_instance::is_hardware_encode()
 {
 	return _hwinst != nullptr;
@@ -1069,6 +1321,7 @@ void ffmpeg_factory::get_defaults2(obs_data_t* settings)
 		obs_data_set_default_string(settings, ST_KEY_FFMPEG_CUSTOMSETTINGS, "");
 		obs_data_set_default_int(settings, ST_KEY_FFMPEG_THREADS, 0);
 		obs_data_set_default_int(settings, ST_KEY_FFMPEG_GPU, -1);
+		obs_data_set_default_bool(settings, ST_KEY_FFMPEG_PIPELINED, false);
 	}
 }
 
@@ -1166,6 +1419,10 @@ obs_properties_t* ffmpeg_factory::get_properties2(instance_t* data)
 												   static_cast<int64_t>(std::thread::hardware_concurrency()) * 2, 1);
 		}
 
+		{ // Pipelined Encoding
+			auto p = obs_properties_add_bool(grp, ST_KEY_FFMPEG_PIPELINED, D_TRANSLATE(ST_I18N_FFMPEG_PIPELINED));
+		}
+
 		{ // Frame Skipping
 			obs_video_info ovi;
 			if (!obs_get_video_info(&ovi)) {
@@ -21,13 +21,14 @@
 
 #pragma once
 #include "common.hpp"
-#include "ffmpeg/avframe-queue.hpp"
+#include "ffmpeg/avframe-pool.hpp"
 #include "ffmpeg/hwapi/base.hpp"
 #include "ffmpeg/swscale.hpp"
 #include "handlers/handler.hpp"
 #include "obs/obs-encoder-factory.hpp"
 
 #include "warning-disable.hpp"
+#include <atomic>
 #include <condition_variable>
 #include <map>
 #include <mutex>
@@ -69,10 +70,29 @@ namespace streamfx::encoder::ffmpeg {
 		std::vector<uint8_t> _extra_data;
 		std::vector<uint8_t> _sei_data;
 
-		// Frame Stack and Queue
-		std::stack<std::shared_ptr<AVFrame>>           _free_frames;
-		std::queue<std::shared_ptr<AVFrame>>           _used_frames;
-		std::chrono::high_resolution_clock::time_point _free_frames_last_used;
+		// Frame Pool and Queue
+		std::shared_ptr<::streamfx::ffmpeg::avframe_pool::size_class> _free_frames;
+		std::queue<std::shared_ptr<AVFrame>>                          _used_frames;
+
+		// Mirror of the frame queue size, for the statistics.
+		std::atomic<size_t> _used_frames_count;
+
+		// Registration with the conversion cache, which only keeps frames for video outputs with several encoders.
+		std::shared_ptr<void> _conversion_consumer;
+
+		// Pipelined Encoding
+		bool                                  _pipelined;
+		std::thread                           _encode_thread;
+		std::mutex                            _encode_lock;
+		std::condition_variable               _encode_cv;
+		std::condition_variable               _encode_done_cv;
+		std::queue<std::shared_ptr<AVFrame>>  _encode_frames;
+		std::queue<std::shared_ptr<AVPacket>> _encode_packets;
+		bool                                  _encode_shutdown;
+		bool                                  _encode_failed;
+
+		// Zero Copy
+		bool _zero_copy;
 
 		public:
 		ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool is_hw);
@@ -98,22 +118,32 @@ namespace streamfx::encoder::ffmpeg {
 
 		void get_video_info(struct video_scale_info* info) override;
 
+		void statistics(obs_data_t* data) override;
+
 		public:
 		void initialize_sw(obs_data_t* settings);
 		void initialize_hw(obs_data_t* settings);
 
-		void                     push_free_frame(std::shared_ptr<AVFrame> frame);
 		std::shared_ptr<AVFrame> pop_free_frame();
 
 		void                     push_used_frame(std::shared_ptr<AVFrame> frame);
 		std::shared_ptr<AVFrame> pop_used_frame();
 
+		std::shared_ptr<AVFrame> wrap_frame(struct encoder_frame* frame);
+
 		int receive_packet(bool* received_packet, struct encoder_packet* packet);
 
+		void process_packet(bool* received_packet, struct encoder_packet* packet);
+
 		int send_frame(std::shared_ptr<AVFrame> frame);
 
 		bool encode_avframe(std::shared_ptr<AVFrame> frame, struct encoder_packet* packet, bool* received_packet);
 
+		bool encode_avframe_pipelined(std::shared_ptr<AVFrame> frame, struct encoder_packet* packet,
+									  bool* received_packet);
+
+		void encode_thread();
+
 		public: // Handler API
 		bool is_hardware_encode();
 
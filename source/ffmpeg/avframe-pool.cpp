@@ -0,0 +1,291 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2022 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "avframe-pool.hpp"
+#include "statistics.hpp"
+#include "tools.hpp"
+
+#include "warning-disable.hpp"
+#include <list>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+extern "C" {
+#include "warning-disable.hpp"
+#include <libavutil/imgutils.h>
+#include "warning-enable.hpp"
+}
+
+using namespace streamfx::ffmpeg;
+
+// How often size classes drop the frames they did not need.
+static constexpr float trim_interval = 10.f;
+
+avframe_pool::size_class::~size_class()
+{
+	for (auto& slot : _slots) {
+		if (AVFrame* frame = slot.exchange(nullptr); frame) {
+			av_frame_free(&frame);
+		}
+	}
+}
+
+avframe_pool::size_class::size_class(int32_t width, int32_t height, AVPixelFormat format, int32_t alignment)
+	: _slots(), _width(width), _height(height), _format(format), _alignment(alignment), _frame_size(0), _leased(0),
+	  _pooled(0), _high_water(0), _hits(0), _misses(0), _trimmed(0)
+{
+	for (auto& slot : _slots) {
+		slot.store(nullptr);
+	}
+
+	int size = av_image_get_buffer_size(format, width, height, alignment);
+	if (size > 0) {
+		_frame_size = static_cast<size_t>(size);
+	}
+}
+
+std::shared_ptr<AVFrame> avframe_pool::size_class::acquire()
+{
+	size_t leased     = ++_leased;
+	size_t high_water = _high_water.load();
+	while ((leased > high_water) && !_high_water.compare_exchange_weak(high_water, leased)) {
+	}
+
+	// Only exchange slots that look filled, so that empty ones are not written to needlessly.
+	AVFrame* frame = nullptr;
+	for (auto& slot : _slots) {
+		if (slot.load(std::memory_order_relaxed) && ((frame = slot.exchange(nullptr)) != nullptr)) {
+			break;
+		}
+	}
+
+	if (frame) {
+		_pooled--;
+		_hits++;
+	} else {
+		_misses++;
+
+		frame = av_frame_alloc();
+		if (!frame) {
+			_leased--;
+			throw std::bad_alloc();
+		}
+
+		frame->width  = _width;
+		frame->height = _height;
+		frame->format = _format;
+
+		int res = av_frame_get_buffer(frame, _alignment);
+		if (res < 0) {
+			av_frame_free(&frame);
+			_leased--;
+			throw std::runtime_error(tools::get_error_description(res));
+		}
+	}
+
+	return std::shared_ptr<AVFrame>(frame, [self = shared_from_this()](AVFrame* ptr) { self->release(ptr); });
+}
+
+void avframe_pool::size_class::trim()
+{
+	size_t leased     = _leased.load();
+	size_t high_water = _high_water.exchange(leased);
+	size_t keep       = (high_water > leased) ? (high_water - leased) : 0;
+
+	for (auto& slot : _slots) {
+		if (_pooled.load() <= keep) {
+			break;
+		}
+
+		if (AVFrame* frame = slot.exchange(nullptr); frame) {
+			_pooled--;
+			_trimmed++;
+			av_frame_free(&frame);
+		}
+	}
+}
+
+size_t avframe_pool::size_class::frame_size()
+{
+	return _frame_size;
+}
+
+size_t avframe_pool::size_class::leased()
+{
+	return _leased.load();
+}
+
+size_t avframe_pool::size_class::pooled()
+{
+	return _pooled.load();
+}
+
+uint64_t avframe_pool::size_class::hits()
+{
+	return _hits.load();
+}
+
+uint64_t avframe_pool::size_class::misses()
+{
+	return _misses.load();
+}
+
+uint64_t avframe_pool::size_class::trimmed()
+{
+	return _trimmed.load();
+}
+
+void avframe_pool::size_class::release(AVFrame* frame)
+{
+	_leased--;
+
+	// Buffers still referenced elsewhere can't be written to again, so only the frame itself is freed.
+	if (av_frame_is_writable(frame)) {
+		for (auto& slot : _slots) {
+			AVFrame* expected = nullptr;
+			if (slot.compare_exchange_strong(expected, frame)) {
+				_pooled++;
+				return;
+			}
+		}
+	}
+
+	av_frame_free(&frame);
+}
+
+avframe_pool::~avframe_pool()
+{
+	obs_remove_tick_callback(tick, this);
+	_statistics.reset();
+
+	// Leased frames keep their size class alive, and return to it until it is destroyed as well.
+	std::lock_guard<std::mutex> lock(_lock);
+	_classes.clear();
+}
+
+avframe_pool::avframe_pool() : _lock(), _classes(), _elapsed(0), _statistics()
+{
+	if (auto stats = ::streamfx::statistics::instance(); stats) {
+		_statistics = stats->add("avframe_pool", [this](obs_data_t* data) {
+			uint64_t hits = 0, misses = 0, trimmed = 0;
+			size_t   leased = 0, leased_bytes = 0, pooled = 0, pooled_bytes = 0;
+
+			std::lock_guard<std::mutex> lock(_lock);
+			for (auto& kv : _classes) {
+				hits += kv.second->hits();
+				misses += kv.second->misses();
+				trimmed += kv.second->trimmed();
+				leased += kv.second->leased();
+				leased_bytes += kv.second->leased() * kv.second->frame_size();
+				pooled += kv.second->pooled();
+				pooled_bytes += kv.second->pooled() * kv.second->frame_size();
+			}
+
+			obs_data_set_int(data, "size_classes", static_cast<long long>(_classes.size()));
+			obs_data_set_int(data, "hits", static_cast<long long>(hits));
+			obs_data_set_int(data, "misses", static_cast<long long>(misses));
+			obs_data_set_int(data, "trimmed", static_cast<long long>(trimmed));
+			obs_data_set_int(data, "leased", static_cast<long long>(leased));
+			obs_data_set_int(data, "leased_memory", static_cast<long long>(leased_bytes));
+			obs_data_set_int(data, "pooled", static_cast<long long>(pooled));
+			obs_data_set_int(data, "pooled_memory", static_cast<long long>(pooled_bytes));
+		});
+	}
+
+	obs_add_tick_callback(tick, this);
+}
+
+std::shared_ptr<avframe_pool::size_class> avframe_pool::get(int32_t width, int32_t height, AVPixelFormat format,
+															 int32_t alignment)
+{
+	key_t key{width, height, format, alignment};
+
+	std::lock_guard<std::mutex> lock(_lock);
+	if (auto kv = _classes.find(key); kv != _classes.end()) {
+		return kv->second;
+	}
+
+	auto entry = std::make_shared<size_class>(width, height, format, alignment);
+	_classes.emplace(key, entry);
+	return entry;
+}
+
+std::shared_ptr<avframe_pool::size_class> avframe_pool::find(int32_t width, int32_t height, AVPixelFormat format,
+															  int32_t alignment)
+{
+	if (auto pool = instance(); pool) {
+		return pool->get(width, height, format, alignment);
+	} else {
+		return std::make_shared<size_class>(width, height, format, alignment);
+	}
+}
+
+void avframe_pool::trim()
+{
+	std::list<std::shared_ptr<size_class>> classes;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		for (auto kv = _classes.begin(); kv != _classes.end();) {
+			// Size classes that only the pool still knows about have no encoder and no leased frame left.
+			if ((kv->second.use_count() == 1) && (kv->second->pooled() == 0)) {
+				kv = _classes.erase(kv);
+			} else {
+				classes.push_back(kv->second);
+				kv++;
+			}
+		}
+	}
+
+	// Free the frames without holding the lock.
+	for (auto& entry : classes) {
+		entry->trim();
+	}
+}
+
+void avframe_pool::tick(void* ptr, float seconds)
+{
+	auto self = reinterpret_cast<avframe_pool*>(ptr);
+
+	self->_elapsed += seconds;
+	if (self->_elapsed >= trim_interval) {
+		self->_elapsed = 0;
+		self->trim();
+	}
+}
+
+static std::shared_ptr<avframe_pool> _instance = nullptr;
+
+void avframe_pool::initialize()
+{
+	if (!_instance) {
+		_instance = std::make_shared<avframe_pool>();
+	}
+}
+
+void avframe_pool::finalize()
+{
+	_instance.reset();
+}
+
+std::shared_ptr<avframe_pool> avframe_pool::instance()
+{
+	return _instance;
+}
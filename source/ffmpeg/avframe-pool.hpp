@@ -0,0 +1,135 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2022 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+
+#include "warning-disable.hpp"
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include "warning-enable.hpp"
+
+extern "C" {
+#include "warning-disable.hpp"
+#include <libavutil/frame.h>
+#include "warning-enable.hpp"
+}
+
+namespace streamfx::ffmpeg {
+	/** Shared software frames for every encoder.
+	 *
+	 * Frames are grouped into size classes by resolution, format and alignment, so that encoders with identical
+	 * settings (for example simulcast outputs) reuse each others buffers. Each size class keeps its free frames in a
+	 * fixed number of slots, which are claimed and filled with atomic exchanges instead of a lock.
+	 */
+	class avframe_pool {
+		public:
+		class size_class : public std::enable_shared_from_this<size_class> {
+			static constexpr size_t slot_count = 32;
+
+			std::array<std::atomic<AVFrame*>, slot_count> _slots;
+
+			int32_t       _width;
+			int32_t       _height;
+			AVPixelFormat _format;
+			int32_t       _alignment;
+			size_t        _frame_size;
+
+			std::atomic<size_t>   _leased;
+			std::atomic<size_t>   _pooled;
+			std::atomic<size_t>   _high_water;
+			std::atomic<uint64_t> _hits;
+			std::atomic<uint64_t> _misses;
+			std::atomic<uint64_t> _trimmed;
+
+			public:
+			~size_class();
+			size_class(int32_t width, int32_t height, AVPixelFormat format, int32_t alignment);
+
+			public:
+			/** Lease a frame, which returns to this size class once the last reference to it is released.
+			 *
+			 * Frames that are still referenced by someone else when released, for example by an encoder that kept a
+			 * reference to the buffers, are not reused.
+			 */
+			std::shared_ptr<AVFrame> acquire();
+
+			/** Free pooled frames that were not needed since the last trim.
+			 *
+			 * Only as many frames are kept as were leased at the same time at most, then the high-water mark restarts
+			 * from the currently leased frames.
+			 */
+			void trim();
+
+			public:
+			size_t   frame_size();
+			size_t   leased();
+			size_t   pooled();
+			uint64_t hits();
+			uint64_t misses();
+			uint64_t trimmed();
+
+			private:
+			void release(AVFrame* frame);
+		};
+
+		private:
+		typedef std::tuple<int32_t, int32_t, AVPixelFormat, int32_t> key_t;
+
+		std::mutex                                   _lock;
+		std::map<key_t, std::shared_ptr<size_class>> _classes;
+		float                                        _elapsed;
+		std::shared_ptr<void>                        _statistics;
+
+		public:
+		~avframe_pool();
+		avframe_pool();
+
+		public:
+		/** Retrieve the shared size class for frames of the given size and format.
+		 *
+		 * Looking up a size class takes a lock, so it should be done once and kept for as long as the settings stay
+		 * the same.
+		 */
+		std::shared_ptr<size_class> get(int32_t width, int32_t height, AVPixelFormat format, int32_t alignment = 32);
+
+		/** Retrieve a size class from the pool, or create a private one if there is no pool.
+		 */
+		static std::shared_ptr<size_class> find(int32_t width, int32_t height, AVPixelFormat format,
+												int32_t alignment = 32);
+
+		/** Trim every size class, and forget the ones that are no longer in use.
+		 */
+		void trim();
+
+		private:
+		static void tick(void* ptr, float seconds);
+
+		public /* Singleton */:
+		static void                                            initialize();
+		static void                                            finalize();
+		static std::shared_ptr<streamfx::ffmpeg::avframe_pool> instance();
+	};
+} // namespace streamfx::ffmpeg
@@ -0,0 +1,178 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2022 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "conversion-cache.hpp"
+#include "statistics.hpp"
+
+#include "warning-disable.hpp"
+#include <new>
+#include "warning-enable.hpp"
+
+using namespace streamfx::ffmpeg;
+
+conversion_cache::~conversion_cache()
+{
+	_statistics.reset();
+
+	std::lock_guard<std::mutex> lock(_lock);
+	_frames.clear();
+}
+
+conversion_cache::conversion_cache() : _lock(), _frames(), _consumers(), _hits(0), _misses(0), _statistics()
+{
+	if (auto stats = ::streamfx::statistics::instance(); stats) {
+		_statistics = stats->add("conversion_cache", [this](obs_data_t* data) {
+			std::lock_guard<std::mutex> lock(_lock);
+			obs_data_set_int(data, "frames", static_cast<long long>(_frames.size()));
+			obs_data_set_int(data, "hits", static_cast<long long>(_hits));
+			obs_data_set_int(data, "misses", static_cast<long long>(_misses));
+		});
+	}
+}
+
+std::shared_ptr<void> conversion_cache::attach(const video_t* video)
+{
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_consumers[video]++;
+	}
+
+	// The handle only holds a weak reference, so that encoders may outlive the cache.
+	std::weak_ptr<conversion_cache> self = instance();
+	return std::shared_ptr<void>(nullptr, [self, video](void*) {
+		if (auto strong = self.lock(); strong) {
+			strong->detach(video);
+		}
+	});
+}
+
+std::shared_ptr<AVFrame> conversion_cache::find(const key_t& key)
+{
+	std::shared_ptr<AVFrame> frame;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		if (auto kv = _frames.find(key); kv != _frames.end()) {
+			frame = kv->second;
+			_hits++;
+		} else {
+			_misses++;
+			return nullptr;
+		}
+	}
+
+	return share(frame);
+}
+
+void conversion_cache::insert(const key_t& key, std::shared_ptr<AVFrame> frame)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	// Without another encoder on the same video output, nobody would ever ask for the frame.
+	auto consumers = _consumers.find(std::get<0>(key));
+	bool is_shared = (consumers != _consumers.end()) && (consumers->second > 1);
+
+	for (auto kv = _frames.begin(); kv != _frames.end();) {
+		if ((std::get<0>(kv->first) == std::get<0>(key))
+			&& (!is_shared || (std::get<1>(kv->first) != std::get<1>(key)))) {
+			kv = _frames.erase(kv);
+		} else {
+			kv++;
+		}
+	}
+	if (is_shared) {
+		_frames.insert_or_assign(key, frame);
+	}
+}
+
+void conversion_cache::detach(const video_t* video)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	if (auto consumers = _consumers.find(video); (consumers != _consumers.end()) && (--consumers->second == 0)) {
+		_consumers.erase(consumers);
+	}
+
+	// A single remaining encoder has nobody to share its frames with.
+	if (auto consumers = _consumers.find(video); (consumers == _consumers.end()) || (consumers->second <= 1)) {
+		for (auto kv = _frames.begin(); kv != _frames.end();) {
+			if (std::get<0>(kv->first) == video) {
+				kv = _frames.erase(kv);
+			} else {
+				kv++;
+			}
+		}
+	}
+}
+
+std::shared_ptr<AVFrame> conversion_cache::share(std::shared_ptr<AVFrame> frame)
+{
+	std::shared_ptr<AVFrame> shared{av_frame_alloc(), [](AVFrame* ptr) { av_frame_free(&ptr); }};
+	if (!shared) {
+		throw std::bad_alloc();
+	}
+
+	shared->width  = frame->width;
+	shared->height = frame->height;
+	shared->format = frame->format;
+	av_frame_copy_props(shared.get(), frame.get());
+	for (size_t idx = 0; idx < AV_NUM_DATA_POINTERS; idx++) {
+		shared->data[idx]     = frame->data[idx];
+		shared->linesize[idx] = frame->linesize[idx];
+	}
+
+	// Each buffer keeps the original frame alive instead of adding a reference to its buffers, so that the original
+	// frame is still writable, and thus reusable, once it returns to its pool.
+	for (size_t idx = 0; idx < AV_NUM_DATA_POINTERS; idx++) {
+		if (!frame->buf[idx]) {
+			continue;
+		}
+
+		auto owner       = new std::shared_ptr<AVFrame>(frame);
+		shared->buf[idx] = av_buffer_create(
+			frame->buf[idx]->data, frame->buf[idx]->size,
+			[](void* opaque, uint8_t*) { delete reinterpret_cast<std::shared_ptr<AVFrame>*>(opaque); }, owner,
+			AV_BUFFER_FLAG_READONLY);
+		if (!shared->buf[idx]) {
+			delete owner;
+			throw std::bad_alloc();
+		}
+	}
+
+	return shared;
+}
+
+static std::shared_ptr<conversion_cache> _instance = nullptr;
+
+void conversion_cache::initialize()
+{
+	if (!_instance) {
+		_instance = std::make_shared<conversion_cache>();
+	}
+}
+
+void conversion_cache::finalize()
+{
+	_instance.reset();
+}
+
+std::shared_ptr<conversion_cache> conversion_cache::instance()
+{
+	return _instance;
+}
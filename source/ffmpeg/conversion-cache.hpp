@@ -0,0 +1,98 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2022 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+
+#include "warning-disable.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include "warning-enable.hpp"
+
+extern "C" {
+#include "warning-disable.hpp"
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+#include "warning-enable.hpp"
+}
+
+namespace streamfx::ffmpeg {
+	/** Converted frames shared between encoders of the same video output.
+	 *
+	 * Encoders attached to the same video output receive the same raw frame one after another, so the first one to
+	 * convert it stores the result here, and every following encoder that wants the same target reuses it. Frames are
+	 * identified by their video output, its frame counter at the time and the raw data pointer.
+	 */
+	class conversion_cache {
+		public:
+		/** Video output, frame number, raw data, source format, range, color space, width, height, target format,
+		 * range and color space. */
+		typedef std::tuple<const video_t*, uint32_t, const uint8_t*, AVPixelFormat, bool, AVColorSpace, uint32_t,
+						   uint32_t, AVPixelFormat, bool, AVColorSpace>
+			key_t;
+
+		private:
+		std::mutex                                _lock;
+		std::map<key_t, std::shared_ptr<AVFrame>> _frames;
+		std::map<const video_t*, size_t>          _consumers;
+
+		uint64_t              _hits;
+		uint64_t              _misses;
+		std::shared_ptr<void> _statistics;
+
+		public:
+		~conversion_cache();
+		conversion_cache();
+
+		public:
+		/** Register an encoder of the video output, for as long as the returned handle is kept.
+		 *
+		 * Frames are only kept while at least two encoders of the same video output may ask for them.
+		 */
+		std::shared_ptr<void> attach(const video_t* video);
+
+		/** Look up an already converted frame.
+		 *
+		 * @return A new frame sharing the converted data, with its own properties, or nullptr if there is none.
+		 */
+		std::shared_ptr<AVFrame> find(const key_t& key);
+
+		/** Offer a converted frame to the other encoders.
+		 *
+		 * Frames of older frame numbers from the same video output are released, as no encoder will ask for them again.
+		 * The frame is not kept at all if no other encoder is attached to the video output. The frame must not be
+		 * written to afterwards.
+		 */
+		void insert(const key_t& key, std::shared_ptr<AVFrame> frame);
+
+		private:
+		void detach(const video_t* video);
+
+		static std::shared_ptr<AVFrame> share(std::shared_ptr<AVFrame> frame);
+
+		public /* Singleton */:
+		static void                                                initialize();
+		static void                                                finalize();
+		static std::shared_ptr<streamfx::ffmpeg::conversion_cache> instance();
+	};
+} // namespace streamfx::ffmpeg
@@ -0,0 +1,544 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2022 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "swscale-kernels.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#if defined(D_PLATFORM_INSTR_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#elif defined(D_PLATFORM_INSTR_ARM) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#include <arm_neon.h>
+#endif
+#include "warning-enable.hpp"
+
+// SSE2 is part of x86-64, so it only needs to be checked for on 32-bit x86. AVX2 is optional even with the v2
+// target, so it is compiled per function and only selected if the CPU reports support for it.
+#if defined(D_PLATFORM_INSTR_X86) && (defined(D_PLATFORM_64BIT) || defined(__SSE2__) || (_M_IX86_FP >= 2))
+#define D_KERNELS_SSE2
+#define D_KERNELS_AVX2
+#if defined(_MSC_VER) && !defined(__clang__)
+#define D_TARGET_AVX2
+#else
+#define D_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(D_PLATFORM_INSTR_ARM) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define D_KERNELS_NEON
+#endif
+
+using namespace streamfx::ffmpeg;
+
+namespace {
+	// Expanding 8-bit to 10-bit values:
+	// - Limited range luma maps 16..235 to 64..940, which is a plain shift.
+	// - Full range luma maps 0..255 to 0..1023, which needs the top bits replicated into the new low bits.
+	// - Chroma is centered on 128, which has to stay at 512 in either range, so it is always a plain shift.
+	// P010 then stores the 10-bit value in the upper bits of each 16-bit word, so the result is (v << 8) for chroma and
+	// limited range luma, and (v << 8) | (v & 0xC0) for full range luma.
+
+	struct scalar {
+		static void deinterleave(const uint8_t* uv, uint8_t* u, uint8_t* v, size_t count)
+		{
+			for (size_t idx = 0; idx < count; idx++) {
+				u[idx] = uv[idx * 2];
+				v[idx] = uv[idx * 2 + 1];
+			}
+		}
+
+		static void interleave(const uint8_t* u, const uint8_t* v, uint8_t* uv, size_t count)
+		{
+			for (size_t idx = 0; idx < count; idx++) {
+				uv[idx * 2]     = u[idx];
+				uv[idx * 2 + 1] = v[idx];
+			}
+		}
+
+		static void widen(const uint8_t* source, uint16_t* target, size_t count, bool full_range)
+		{
+			const uint8_t mask = full_range ? 0xC0 : 0x00;
+			for (size_t idx = 0; idx < count; idx++) {
+				target[idx] = static_cast<uint16_t>((source[idx] << 8) | (source[idx] & mask));
+			}
+		}
+
+		static void interleave_widen(const uint8_t* u, const uint8_t* v, uint16_t* uv, size_t count, bool full_range)
+		{
+			const uint8_t mask = full_range ? 0xC0 : 0x00;
+			for (size_t idx = 0; idx < count; idx++) {
+				uv[idx * 2]     = static_cast<uint16_t>((u[idx] << 8) | (u[idx] & mask));
+				uv[idx * 2 + 1] = static_cast<uint16_t>((v[idx] << 8) | (v[idx] & mask));
+			}
+		}
+
+		/** Average 2x2 blocks of two rows 'width' samples wide, repeating the last column if 'width' is odd. */
+		static void downsample(const uint8_t* row0, const uint8_t* row1, uint8_t* target, size_t count, size_t width)
+		{
+			for (size_t idx = 0; idx < count; idx++) {
+				size_t x0 = idx * 2;
+				size_t x1 = std::min(x0 + 1, width - 1);
+
+				target[idx] = static_cast<uint8_t>((row0[x0] + row0[x1] + row1[x0] + row1[x1] + 2) >> 2);
+			}
+		}
+	};
+
+#ifdef D_KERNELS_SSE2
+	struct sse2 {
+		static inline void store_widened(__m128i value, uint16_t* target, bool full_range)
+		{
+			__m128i low =
+				full_range ? _mm_and_si128(value, _mm_set1_epi8(static_cast<char>(0xC0))) : _mm_setzero_si128();
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_unpacklo_epi8(low, value));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(target + 8), _mm_unpackhi_epi8(low, value));
+		}
+
+		static inline __m128i sum_pairs(__m128i value)
+		{
+			return _mm_add_epi16(_mm_and_si128(value, _mm_set1_epi16(0x00FF)), _mm_srli_epi16(value, 8));
+		}
+
+		static void deinterleave(const uint8_t* uv, uint8_t* u, uint8_t* v, size_t count)
+		{
+			const __m128i mask = _mm_set1_epi16(0x00FF);
+
+			size_t idx = 0;
+			for (; (idx + 16) <= count; idx += 16) {
+				__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + idx * 2));
+				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + idx * 2 + 16));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(u + idx),
+								 _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(v + idx),
+								 _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+			}
+			scalar::deinterleave(uv + idx * 2, u + idx, v + idx, count - idx);
+		}
+
+		static void interleave(const uint8_t* u, const uint8_t* v, uint8_t* uv, size_t count)
+		{
+			size_t idx = 0;
+			for (; (idx + 16) <= count; idx += 16) {
+				__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + idx));
+				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + idx));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(uv + idx * 2), _mm_unpacklo_epi8(a, b));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(uv + idx * 2 + 16), _mm_unpackhi_epi8(a, b));
+			}
+			scalar::interleave(u + idx, v + idx, uv + idx * 2, count - idx);
+		}
+
+		static void widen(const uint8_t* source, uint16_t* target, size_t count, bool full_range)
+		{
+			size_t idx = 0;
+			for (; (idx + 16) <= count; idx += 16) {
+				__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + idx));
+				store_widened(value, target + idx, full_range);
+			}
+			scalar::widen(source + idx, target + idx, count - idx, full_range);
+		}
+
+		static void interleave_widen(const uint8_t* u, const uint8_t* v, uint16_t* uv, size_t count, bool full_range)
+		{
+			size_t idx = 0;
+			for (; (idx + 16) <= count; idx += 16) {
+				__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + idx));
+				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + idx));
+				store_widened(_mm_unpacklo_epi8(a, b), uv + idx * 2, full_range);
+				store_widened(_mm_unpackhi_epi8(a, b), uv + idx * 2 + 16, full_range);
+			}
+			scalar::interleave_widen(u + idx, v + idx, uv + idx * 2, count - idx, full_range);
+		}
+
+		static void downsample(const uint8_t* row0, const uint8_t* row1, uint8_t* target, size_t count, size_t width)
+		{
+			const __m128i round = _mm_set1_epi16(2);
+
+			// Only complete pairs of columns, the odd column at the end is left to the scalar code.
+			size_t idx = 0;
+			for (; ((idx + 16) <= count) && ((idx + 16) * 2 <= width); idx += 16) {
+				__m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + idx * 2));
+				__m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + idx * 2 + 16));
+				__m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + idx * 2));
+				__m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + idx * 2 + 16));
+				__m128i s0 = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(sum_pairs(a0), sum_pairs(b0)), round), 2);
+				__m128i s1 = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(sum_pairs(a1), sum_pairs(b1)), round), 2);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(target + idx), _mm_packus_epi16(s0, s1));
+			}
+			scalar::downsample(row0 + idx * 2, row1 + idx * 2, target + idx, count - idx, width - idx * 2);
+		}
+	};
+#endif
+
+#ifdef D_KERNELS_AVX2
+	// 256-bit pack and unpack instructions work on each 128-bit lane separately, so their results are put back into
+	// order with a cross-lane permute.
+	D_TARGET_AVX2 inline void avx2_store_widened(__m256i value, uint16_t* target, bool full_range)
+	{
+		__m256i low = full_range ? _mm256_and_si256(value, _mm256_set1_epi8(static_cast<char>(0xC0)))
+								 : _mm256_setzero_si256();
+		__m256i lo  = _mm256_unpacklo_epi8(low, value);
+		__m256i hi  = _mm256_unpackhi_epi8(low, value);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(target), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(target + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+
+	D_TARGET_AVX2 inline __m256i avx2_sum_pairs(__m256i value)
+	{
+		return _mm256_add_epi16(_mm256_and_si256(value, _mm256_set1_epi16(0x00FF)), _mm256_srli_epi16(value, 8));
+	}
+
+	D_TARGET_AVX2 void avx2_deinterleave(const uint8_t* uv, uint8_t* u, uint8_t* v, size_t count)
+	{
+		const __m256i mask = _mm256_set1_epi16(0x00FF);
+
+		size_t idx = 0;
+		for (; (idx + 32) <= count; idx += 32) {
+			__m256i a  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(uv + idx * 2));
+			__m256i b  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(uv + idx * 2 + 32));
+			__m256i us = _mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+			__m256i vs = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(u + idx), _mm256_permute4x64_epi64(us, 0xD8));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(v + idx), _mm256_permute4x64_epi64(vs, 0xD8));
+		}
+		sse2::deinterleave(uv + idx * 2, u + idx, v + idx, count - idx);
+	}
+
+	D_TARGET_AVX2 void avx2_interleave(const uint8_t* u, const uint8_t* v, uint8_t* uv, size_t count)
+	{
+		size_t idx = 0;
+		for (; (idx + 32) <= count; idx += 32) {
+			__m256i a  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(u + idx));
+			__m256i b  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + idx));
+			__m256i lo = _mm256_unpacklo_epi8(a, b);
+			__m256i hi = _mm256_unpackhi_epi8(a, b);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(uv + idx * 2), _mm256_permute2x128_si256(lo, hi, 0x20));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(uv + idx * 2 + 32),
+								_mm256_permute2x128_si256(lo, hi, 0x31));
+		}
+		sse2::interleave(u + idx, v + idx, uv + idx * 2, count - idx);
+	}
+
+	D_TARGET_AVX2 void avx2_widen(const uint8_t* source, uint16_t* target, size_t count, bool full_range)
+	{
+		size_t idx = 0;
+		for (; (idx + 32) <= count; idx += 32) {
+			avx2_store_widened(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + idx)), target + idx,
+							   full_range);
+		}
+		sse2::widen(source + idx, target + idx, count - idx, full_range);
+	}
+
+	D_TARGET_AVX2 void avx2_interleave_widen(const uint8_t* u, const uint8_t* v, uint16_t* uv, size_t count,
+											 bool full_range)
+	{
+		size_t idx = 0;
+		for (; (idx + 32) <= count; idx += 32) {
+			__m256i a  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(u + idx));
+			__m256i b  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + idx));
+			__m256i lo = _mm256_unpacklo_epi8(a, b);
+			__m256i hi = _mm256_unpackhi_epi8(a, b);
+			avx2_store_widened(_mm256_permute2x128_si256(lo, hi, 0x20), uv + idx * 2, full_range);
+			avx2_store_widened(_mm256_permute2x128_si256(lo, hi, 0x31), uv + idx * 2 + 32, full_range);
+		}
+		sse2::interleave_widen(u + idx, v + idx, uv + idx * 2, count - idx, full_range);
+	}
+
+	D_TARGET_AVX2 void avx2_downsample(const uint8_t* row0, const uint8_t* row1, uint8_t* target, size_t count,
+									   size_t width)
+	{
+		const __m256i round = _mm256_set1_epi16(2);
+
+		size_t idx = 0;
+		for (; ((idx + 32) <= count) && ((idx + 32) * 2 <= width); idx += 32) {
+			__m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + idx * 2));
+			__m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + idx * 2 + 32));
+			__m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + idx * 2));
+			__m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + idx * 2 + 32));
+			__m256i s0 = _mm256_add_epi16(_mm256_add_epi16(avx2_sum_pairs(a0), avx2_sum_pairs(b0)), round);
+			__m256i s1 = _mm256_add_epi16(_mm256_add_epi16(avx2_sum_pairs(a1), avx2_sum_pairs(b1)), round);
+			__m256i packed = _mm256_packus_epi16(_mm256_srli_epi16(s0, 2), _mm256_srli_epi16(s1, 2));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(target + idx), _mm256_permute4x64_epi64(packed, 0xD8));
+		}
+		sse2::downsample(row0 + idx * 2, row1 + idx * 2, target + idx, count - idx, width - idx * 2);
+	}
+
+	struct avx2 {
+		static constexpr auto deinterleave     = &avx2_deinterleave;
+		static constexpr auto interleave       = &avx2_interleave;
+		static constexpr auto widen            = &avx2_widen;
+		static constexpr auto interleave_widen = &avx2_interleave_widen;
+		static constexpr auto downsample       = &avx2_downsample;
+	};
+
+	bool has_avx2()
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+
+		// The OS also has to save the upper halves of the registers, or using them corrupts other threads.
+		__cpuid(info, 1);
+		if (((info[2] & (1 << 27)) == 0) || ((info[2] & (1 << 28)) == 0) || ((_xgetbv(0) & 0x6) != 0x6)) {
+			return false;
+		}
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+
+#ifdef D_KERNELS_NEON
+	struct neon {
+		static inline void store_widened(uint8x16_t value, uint16_t* target, bool full_range)
+		{
+			uint16x8_t lo = vshll_n_u8(vget_low_u8(value), 8);
+			uint16x8_t hi = vshll_n_u8(vget_high_u8(value), 8);
+			if (full_range) {
+				uint8x16_t top = vandq_u8(value, vdupq_n_u8(0xC0));
+				lo             = vorrq_u16(lo, vmovl_u8(vget_low_u8(top)));
+				hi             = vorrq_u16(hi, vmovl_u8(vget_high_u8(top)));
+			}
+			vst1q_u16(target, lo);
+			vst1q_u16(target + 8, hi);
+		}
+
+		static void deinterleave(const uint8_t* uv, uint8_t* u, uint8_t* v, size_t count)
+		{
+			size_t idx = 0;
+			for (; (idx + 16) <= count; idx += 16) {
+				uint8x16x2_t pairs = vld2q_u8(uv + idx * 2);
+				vst1q_u8(u + idx, pairs.val[0]);
+				vst1q_u8(v + idx, pairs.val[1]);
+			}
+			scalar::deinterleave(uv + idx * 2, u + idx, v + idx, count - idx);
+		}
+
+		static void interleave(const uint8_t* u, const uint8_t* v, uint8_t* uv, size_t count)
+		{
+			size_t idx = 0;
+			for (; (idx + 16) <= count; idx += 16) {
+				uint8x16x2_t pairs;
+				pairs.val[0] = vld1q_u8(u + idx);
+				pairs.val[1] = vld1q_u8(v + idx);
+				vst2q_u8(uv + idx * 2, pairs);
+			}
+			scalar::interleave(u + idx, v + idx, uv + idx * 2, count - idx);
+		}
+
+		static void widen(const uint8_t* source, uint16_t* target, size_t count, bool full_range)
+		{
+			size_t idx = 0;
+			for (; (idx + 16) <= count; idx += 16) {
+				store_widened(vld1q_u8(source + idx), target + idx, full_range);
+			}
+			scalar::widen(source + idx, target + idx, count - idx, full_range);
+		}
+
+		static void interleave_widen(const uint8_t* u, const uint8_t* v, uint16_t* uv, size_t count, bool full_range)
+		{
+			size_t idx = 0;
+			for (; (idx + 16) <= count; idx += 16) {
+				uint8x16x2_t pairs = vzipq_u8(vld1q_u8(u + idx), vld1q_u8(v + idx));
+				store_widened(pairs.val[0], uv + idx * 2, full_range);
+				store_widened(pairs.val[1], uv + idx * 2 + 16, full_range);
+			}
+			scalar::interleave_widen(u + idx, v + idx, uv + idx * 2, count - idx, full_range);
+		}
+
+		static void downsample(const uint8_t* row0, const uint8_t* row1, uint8_t* target, size_t count, size_t width)
+		{
+			size_t idx = 0;
+			for (; ((idx + 16) <= count) && ((idx + 16) * 2 <= width); idx += 16) {
+				uint16x8_t s0 = vaddq_u16(vpaddlq_u8(vld1q_u8(row0 + idx * 2)), vpaddlq_u8(vld1q_u8(row1 + idx * 2)));
+				uint16x8_t s1 =
+					vaddq_u16(vpaddlq_u8(vld1q_u8(row0 + idx * 2 + 16)), vpaddlq_u8(vld1q_u8(row1 + idx * 2 + 16)));
+				vst1q_u8(target + idx, vcombine_u8(vrshrn_n_u16(s0, 2), vrshrn_n_u16(s1, 2)));
+			}
+			scalar::downsample(row0 + idx * 2, row1 + idx * 2, target + idx, count - idx, width - idx * 2);
+		}
+	};
+#endif
+
+	inline const uint8_t* source_row(const kernels::planes_t& planes, size_t plane, uint32_t row)
+	{
+		return planes.source_data[plane] + static_cast<ptrdiff_t>(row) * planes.source_stride[plane];
+	}
+
+	inline uint8_t* target_row(const kernels::planes_t& planes, size_t plane, uint32_t row)
+	{
+		return planes.target_data[plane] + static_cast<ptrdiff_t>(row) * planes.target_stride[plane];
+	}
+
+	inline uint16_t* target_row16(const kernels::planes_t& planes, size_t plane, uint32_t row)
+	{
+		return reinterpret_cast<uint16_t*>(target_row(planes, plane, row));
+	}
+
+	void copy_luma(const kernels::planes_t& planes, uint32_t begin, uint32_t end)
+	{
+		for (uint32_t y = begin; y < end; y++) {
+			memcpy(target_row(planes, 0, y), source_row(planes, 0, y), planes.width);
+		}
+	}
+
+	template<typename ops>
+	void widen_luma(const kernels::planes_t& planes, uint32_t begin, uint32_t end)
+	{
+		for (uint32_t y = begin; y < end; y++) {
+			ops::widen(source_row(planes, 0, y), target_row16(planes, 0, y), planes.width, planes.full_range);
+		}
+	}
+
+	template<typename ops>
+	void nv12_to_i420(const kernels::planes_t& planes, uint32_t begin, uint32_t end)
+	{
+		copy_luma(planes, begin, end);
+		for (uint32_t y = begin / 2, ye = (end + 1) / 2, width = (planes.width + 1) / 2; y < ye; y++) {
+			ops::deinterleave(source_row(planes, 1, y), target_row(planes, 1, y), target_row(planes, 2, y), width);
+		}
+	}
+
+	template<typename ops>
+	void i420_to_nv12(const kernels::planes_t& planes, uint32_t begin, uint32_t end)
+	{
+		copy_luma(planes, begin, end);
+		for (uint32_t y = begin / 2, ye = (end + 1) / 2, width = (planes.width + 1) / 2; y < ye; y++) {
+			ops::interleave(source_row(planes, 1, y), source_row(planes, 2, y), target_row(planes, 1, y), width);
+		}
+	}
+
+	template<typename ops>
+	void nv12_to_p010(const kernels::planes_t& planes, uint32_t begin, uint32_t end)
+	{
+		widen_luma<ops>(planes, begin, end);
+		for (uint32_t y = begin / 2, ye = (end + 1) / 2, width = (planes.width + 1) / 2; y < ye; y++) {
+			ops::widen(source_row(planes, 1, y), target_row16(planes, 1, y), width * 2, false);
+		}
+	}
+
+	template<typename ops>
+	void i420_to_p010(const kernels::planes_t& planes, uint32_t begin, uint32_t end)
+	{
+		widen_luma<ops>(planes, begin, end);
+		for (uint32_t y = begin / 2, ye = (end + 1) / 2, width = (planes.width + 1) / 2; y < ye; y++) {
+			ops::interleave_widen(source_row(planes, 1, y), source_row(planes, 2, y), target_row16(planes, 1, y),
+								  width, false);
+		}
+	}
+
+	template<typename ops>
+	void i444_to_i420(const kernels::planes_t& planes, uint32_t begin, uint32_t end)
+	{
+		copy_luma(planes, begin, end);
+		for (uint32_t y = begin / 2, ye = (end + 1) / 2, width = (planes.width + 1) / 2; y < ye; y++) {
+			// The last row is repeated for frames with an odd height.
+			uint32_t y0 = y * 2;
+			uint32_t y1 = std::min(y0 + 1, planes.height - 1);
+			for (size_t plane = 1; plane <= 2; plane++) {
+				ops::downsample(source_row(planes, plane, y0), source_row(planes, plane, y1),
+								target_row(planes, plane, y), width, planes.width);
+			}
+		}
+	}
+
+	struct table_t {
+		const char*       name;
+		kernels::kernel_t nv12_to_i420;
+		kernels::kernel_t i420_to_nv12;
+		kernels::kernel_t nv12_to_p010;
+		kernels::kernel_t i420_to_p010;
+		kernels::kernel_t i444_to_i420;
+	};
+
+	template<typename ops>
+	table_t make_table(const char* name)
+	{
+		return table_t{name,
+					   &::nv12_to_i420<ops>,
+					   &::i420_to_nv12<ops>,
+					   &::nv12_to_p010<ops>,
+					   &::i420_to_p010<ops>,
+					   &::i444_to_i420<ops>};
+	}
+
+	const table_t& table()
+	{
+		static const table_t instance = []() {
+#if defined(D_KERNELS_AVX2)
+			if (has_avx2()) {
+				return make_table<avx2>("AVX2");
+			}
+#endif
+#if defined(D_KERNELS_SSE2)
+			return make_table<sse2>("SSE2");
+#elif defined(D_KERNELS_NEON)
+			return make_table<neon>("NEON");
+#else
+			return make_table<scalar>("C");
+#endif
+		}();
+		return instance;
+	}
+} // namespace
+
+kernels::kernel_t kernels::find(AVPixelFormat source, AVPixelFormat target)
+{
+	const table_t& entries = table();
+	switch (source) {
+	case AV_PIX_FMT_NV12:
+		switch (target) {
+		case AV_PIX_FMT_YUV420P:
+			return entries.nv12_to_i420;
+		case AV_PIX_FMT_P010:
+			return entries.nv12_to_p010;
+		default:
+			return nullptr;
+		}
+	case AV_PIX_FMT_YUV420P:
+		switch (target) {
+		case AV_PIX_FMT_NV12:
+			return entries.i420_to_nv12;
+		case AV_PIX_FMT_P010:
+			return entries.i420_to_p010;
+		default:
+			return nullptr;
+		}
+	case AV_PIX_FMT_YUV444P:
+		return (target == AV_PIX_FMT_YUV420P) ? entries.i444_to_i420 : nullptr;
+	default:
+		return nullptr;
+	}
+}
+
+const char* kernels::instruction_set()
+{
+	return table().name;
+}
@@ -0,0 +1,60 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2022 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+
+extern "C" {
+#include "warning-disable.hpp"
+#include <libavutil/pixfmt.h>
+#include "warning-enable.hpp"
+}
+
+namespace streamfx::ffmpeg::kernels {
+	struct planes_t {
+		const uint8_t* const* source_data;
+		const int*            source_stride;
+		uint8_t* const*       target_data;
+		const int*            target_stride;
+		uint32_t              width;
+		uint32_t              height;
+		bool                  full_range;
+	};
+
+	/** Convert the luma rows [begin, end) of a frame, and the chroma rows belonging to them.
+	 *
+	 * 'begin' must be a multiple of two, so that bands never share a row of subsampled chroma.
+	 */
+	typedef void (*kernel_t)(const planes_t& planes, uint32_t begin, uint32_t end);
+
+	/** Find a kernel for a conversion that only changes the memory layout of a frame.
+	 *
+	 * Kernels don't scale and don't convert between color spaces or ranges, so they may only be used if both sides
+	 * share the same size, color space and range. Subsampling chroma (I444 to I420) uses a rounded 2x2 average,
+	 * which is not bit-exact with libswscale.
+	 *
+	 * @return The kernel for the fastest instruction set this CPU supports, or nullptr if there is none.
+	 */
+	kernel_t find(AVPixelFormat source, AVPixelFormat target);
+
+	/** Name of the instruction set that kernels were selected for. */
+	const char* instruction_set();
+} // namespace streamfx::ffmpeg::kernels
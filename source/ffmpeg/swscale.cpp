@@ -20,11 +20,20 @@
 // SOFTWARE.
 
 #include "swscale.hpp"
+#include "plugin.hpp"
 
 #include "warning-disable.hpp"
+#include <atomic>
 #include <stdexcept>
+#include <thread>
 #include "warning-enable.hpp"
 
+extern "C" {
+#include "warning-disable.hpp"
+#include <libavutil/pixdesc.h>
+#include "warning-enable.hpp"
+}
+
 using namespace streamfx::ffmpeg;
 
 swscale::swscale() = default;
@@ -186,11 +195,57 @@ bool swscale::initialize(int flags)
 							 sws_getCoefficients(target_colorspace), target_full_range ? 1 : 0, 1L << 16 | 0L,
 							 1L << 16 | 0L, 1L << 16 | 0L);
 
+	if ((source_size == target_size) && (source_full_range == target_full_range)
+		&& (source_colorspace == target_colorspace)) {
+		kernel = kernels::find(source_format, target_format);
+	}
+
+	// Conversions that don't resample vertically produce every output row from the same input row, so they can be
+	// split into independent bands of rows which are converted in parallel.
+	const AVPixFmtDescriptor* source_desc = av_pix_fmt_desc_get(source_format);
+	const AVPixFmtDescriptor* target_desc = av_pix_fmt_desc_get(target_format);
+	if ((source_size == target_size) && source_desc && target_desc
+		&& (source_desc->log2_chroma_h == target_desc->log2_chroma_h)
+		&& !((source_desc->flags | target_desc->flags) & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM))) {
+		constexpr uint32_t minimum_rows = 128;
+
+		uint32_t bands = std::min<uint32_t>(std::thread::hardware_concurrency(), target_size.second / minimum_rows);
+		if (bands > 1) {
+			// Align bands to 16 rows, so that chroma rows and dither patterns line up with a full frame conversion.
+			slice_height = ((target_size.second / bands) + 15) & ~15u;
+			for (uint32_t y = 0; y < target_size.second; y += slice_height) {
+				int         rows = static_cast<int>(std::min(slice_height, target_size.second - y));
+				SwsContext* ctx  = sws_getContext(static_cast<int>(source_size.first), rows, source_format,
+												  static_cast<int>(target_size.first), rows, target_format, flags,
+												  nullptr, nullptr, nullptr);
+				if (!ctx) { // Not fatal, just convert the whole frame at once instead.
+					for (auto slice_ctx : slice_contexts) {
+						sws_freeContext(slice_ctx);
+					}
+					slice_contexts.clear();
+					break;
+				}
+
+				sws_setColorspaceDetails(ctx, sws_getCoefficients(source_colorspace), source_full_range ? 1 : 0,
+										 sws_getCoefficients(target_colorspace), target_full_range ? 1 : 0,
+										 1L << 16 | 0L, 1L << 16 | 0L, 1L << 16 | 0L);
+				slice_contexts.push_back(ctx);
+			}
+		}
+	}
+
 	return true;
 }
 
 bool swscale::finalize()
 {
+	for (auto slice_ctx : slice_contexts) {
+		sws_freeContext(slice_ctx);
+	}
+	slice_contexts.clear();
+	slice_height = 0;
+	kernel       = nullptr;
+
 	if (this->context) {
 		sws_freeContext(this->context);
 		this->context = nullptr;
@@ -205,6 +260,58 @@ int32_t swscale::convert(const uint8_t* const source_data[], const int source_st
 	if (!this->context) {
 		return 0;
 	}
+
+	if (kernel && (source_row == 0) && (source_rows == static_cast<int32_t>(source_size.second))) {
+		kernels::planes_t planes{source_data,       source_stride,      target_data,      target_stride,
+								 source_size.first, source_size.second, target_full_range};
+
+		// Bands are made of pairs of rows, so that no two bands share a row of subsampled chroma.
+		streamfx::threadpool()->parallel_for((source_size.second + 1) / 2, 32, [&](size_t begin, size_t end) {
+			kernel(planes, static_cast<uint32_t>(begin * 2),
+				   static_cast<uint32_t>(std::min<size_t>(end * 2, source_size.second)));
+		});
+
+		return source_rows;
+	}
+
+	if (!slice_contexts.empty() && (source_row == 0) && (source_rows == static_cast<int32_t>(source_size.second))) {
+		const AVPixFmtDescriptor* source_desc = av_pix_fmt_desc_get(source_format);
+		const AVPixFmtDescriptor* target_desc = av_pix_fmt_desc_get(target_format);
+		std::atomic<int32_t>      height{0};
+		std::atomic<int32_t>      error{0};
+
+		streamfx::threadpool()->parallel_for(slice_contexts.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t idx = begin; idx < end; idx++) {
+				uint32_t       y = static_cast<uint32_t>(idx) * slice_height;
+				const uint8_t* source_slice[4];
+				uint8_t*       target_slice[4];
+				for (size_t plane = 0; plane < 4; plane++) {
+					// Only the chroma planes are subsampled, alpha is always full size.
+					bool chroma = (plane == 1) || (plane == 2);
+					source_slice[plane] =
+						source_data[plane]
+							? source_data[plane] + (y >> (chroma ? source_desc->log2_chroma_h : 0)) * source_stride[plane]
+							: nullptr;
+					target_slice[plane] =
+						target_data[plane]
+							? target_data[plane] + (y >> (chroma ? target_desc->log2_chroma_h : 0)) * target_stride[plane]
+							: nullptr;
+				}
+
+				int rows = static_cast<int>(std::min(slice_height, source_size.second - y));
+				int res  = sws_scale(slice_contexts[idx], source_slice, source_stride, 0, rows, target_slice,
+									 target_stride);
+				if (res <= 0) {
+					error = res;
+				} else {
+					height += res;
+				}
+			}
+		});
+
+		return (error < 0) ? error.load() : height.load();
+	}
+
 	int height =
 		sws_scale(this->context, source_data, source_stride, source_row, source_rows, target_data, target_stride);
 	return height;
@@ -21,9 +21,11 @@
 
 #pragma once
 #include "common.hpp"
+#include "swscale-kernels.hpp"
 
 #include "warning-disable.hpp"
 #include <utility>
+#include <vector>
 #include "warning-enable.hpp"
 
 extern "C" {
@@ -47,6 +49,13 @@ namespace streamfx::ffmpeg {
 
 		SwsContext* context = nullptr;
 
+		// Independent bands of rows, converted in parallel when possible.
+		std::vector<SwsContext*> slice_contexts;
+		uint32_t                 slice_height = 0;
+
+		// Conversions that only change the memory layout skip libswscale entirely.
+		kernels::kernel_t kernel = nullptr;
+
 		public:
 		swscale();
 		~swscale();
@@ -144,11 +144,14 @@ namespace streamfx::filter::autoframing {
 		virtual void video_tick(float_t seconds) override;
 		virtual void video_render(gs_effect_t* effect) override;
 
+		virtual void statistics(obs_data_t* data) override;
+
 		private:
 		void tracking_tick(float seconds);
 
 		void switch_provider(tracking_provider provider);
 		void task_switch_provider(util::threadpool::task_data_t data);
+		void task_provider_switched(util::threadpool::task_data_t data);
 
 #ifdef ENABLE_FILTER_AUTOFRAMING_NVIDIA
 		void nvar_facedetection_load();
@@ -25,6 +25,7 @@
 #include "gfx/blur/gfx-blur-gaussian-linear.hpp"
 #include "gfx/blur/gfx-blur-gaussian.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/obs-frame-graph.hpp"
 #include "obs/obs-source-tracker.hpp"
 #include "util/util-logging.hpp"
 
@@ -141,7 +142,7 @@ static std::map<std::string, local_blur_subtype_t> list_of_subtypes = {
 
 blur_instance::blur_instance(obs_data_t* settings, obs_source_t* self)
 	: obs::source_instance(settings, self), _gfx_util(::streamfx::gfx::util::get()), _source_rendered(false),
-	  _output_rendered(false)
+	  _output_rendered(false), _frame_graph()
 {
 	{
 		auto gctx = streamfx::obs::gs::context();
@@ -162,9 +163,16 @@ blur_instance::blur_instance(obs_data_t* settings, obs_source_t* self)
 	}
 
 	update(settings);
+
+	if (auto graph = streamfx::obs::frame_graph::instance(); graph) {
+		_frame_graph = graph->add(_self, [this]() { return render_output(); });
+	}
 }
 
-blur_instance::~blur_instance() {}
+blur_instance::~blur_instance()
+{
+	_frame_graph.reset();
+}
 
 bool blur_instance::apply_mask_parameters(streamfx::obs::gs::effect effect, gs_texture_t* original_texture,
 										  gs_texture_t* blurred_texture)
@@ -391,7 +399,7 @@ void blur_instance::video_tick(float)
 	_output_rendered = false;
 }
 
-void blur_instance::video_render(gs_effect_t* effect)
+std::shared_ptr<streamfx::obs::gs::texture> blur_instance::render_output()
 {
 	obs_source_t* parent        = obs_filter_get_parent(this->_self);
 	obs_source_t* target        = obs_filter_get_target(this->_self);
@@ -401,8 +409,7 @@ void blur_instance::video_render(gs_effect_t* effect)
 
 	// Verify that we can actually run first.
 	if (!target || !parent || !this->_self || !this->_blur || (baseW == 0) || (baseH == 0)) {
-		obs_source_skip_video_filter(this->_self);
-		return;
+		return nullptr;
 	}
 
 #ifdef ENABLE_PROFILING
@@ -411,8 +418,14 @@ void blur_instance::video_render(gs_effect_t* effect)
 #endif
 
 	if (!_source_rendered) {
+		// Take the output of the filter above as is, if it is able to hand it over.
+		_source_texture.reset();
+		if (auto graph = streamfx::obs::frame_graph::instance(); graph) {
+			_source_texture = graph->input(_self, baseW, baseH);
+		}
+
 		// Source To Texture
-		{
+		if (!_source_texture) {
 #ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
 #endif
@@ -449,12 +462,10 @@ void blur_instance::video_render(gs_effect_t* effect)
 
 				_source_texture = this->_source_rt->get_texture();
 				if (!_source_texture) {
-					obs_source_skip_video_filter(this->_self);
-					return;
+					return nullptr;
 				}
 			} else {
-				obs_source_skip_video_filter(this->_self);
-				return;
+				return nullptr;
 			}
 		}
 
@@ -551,20 +562,33 @@ void blur_instance::video_render(gs_effect_t* effect)
 				}
 			} catch (const std::exception&) {
 				gs_blend_state_pop();
-				obs_source_skip_video_filter(this->_self);
-				return;
+				return nullptr;
 			}
 			gs_blend_state_pop();
 
 			if (!(_output_texture = this->_output_rt->get_texture())) {
-				obs_source_skip_video_filter(this->_self);
-				return;
+				return nullptr;
 			}
 		}
 
 		_output_rendered = true;
 	}
 
+	return _output_texture;
+}
+
+void blur_instance::video_render(gs_effect_t* effect)
+{
+	obs_source_t* target        = obs_filter_get_target(this->_self);
+	gs_effect_t*  defaultEffect = obs_get_base_effect(obs_base_effect::OBS_EFFECT_DEFAULT);
+	uint32_t      baseW         = obs_source_get_base_width(target);
+	uint32_t      baseH         = obs_source_get_base_height(target);
+
+	if (!render_output()) {
+		obs_source_skip_video_filter(this->_self);
+		return;
+	}
+
 	// Draw source
 	{
 #ifdef ENABLE_PROFILING
@@ -862,18 +886,14 @@ obs_properties_t* blur_factory::get_properties2(blur_instance* data)
 		p = obs_properties_add_list(pr, ST_KEY_MASK_SOURCE, D_TRANSLATE(ST_I18N_MASK_SOURCE), OBS_COMBO_TYPE_LIST,
 									OBS_COMBO_FORMAT_STRING);
 		obs_property_list_add_string(p, "", "");
-		obs::source_tracker::get()->enumerate(
-			[&p](std::string name, obs_source_t*) {
-				obs_property_list_add_string(p, std::string(name + " (Source)").c_str(), name.c_str());
-				return false;
-			},
-			obs::source_tracker::filter_video_sources);
-		obs::source_tracker::get()->enumerate(
-			[&p](std::string name, obs_source_t*) {
-				obs_property_list_add_string(p, std::string(name + " (Scene)").c_str(), name.c_str());
-				return false;
-			},
-			obs::source_tracker::filter_scenes);
+		auto video_sources = obs::source_tracker::get()->names(obs::source_tracker::category::VIDEO);
+		for (auto& name : *video_sources) {
+			obs_property_list_add_string(p, std::string(name + " (Source)").c_str(), name.c_str());
+		}
+		auto scenes = obs::source_tracker::get()->names(obs::source_tracker::category::SCENE);
+		for (auto& name : *scenes) {
+			obs_property_list_add_string(p, std::string(name + " (Scene)").c_str(), name.c_str());
+		}
 
 		/// Shared
 		p = obs_properties_add_color(pr, ST_KEY_MASK_COLOR, D_TRANSLATE(ST_I18N_MASK_COLOR));
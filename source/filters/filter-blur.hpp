@@ -56,6 +56,7 @@ namespace streamfx::filter::blur {
 		std::shared_ptr<streamfx::obs::gs::texture>      _output_texture;
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _output_rt;
 		bool                                             _output_rendered;
+		std::shared_ptr<void>                            _frame_graph;
 
 		// Blur
 		std::shared_ptr<::streamfx::gfx::blur::base> _blur;
@@ -112,6 +113,8 @@ namespace streamfx::filter::blur {
 		virtual void video_render(gs_effect_t* effect) override;
 
 		private:
+		std::shared_ptr<streamfx::obs::gs::texture> render_output();
+
 		bool apply_mask_parameters(streamfx::obs::gs::effect effect, gs_texture_t* original_texture,
 								   gs_texture_t* blurred_texture);
 	};
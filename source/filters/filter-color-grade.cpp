@@ -21,6 +21,7 @@
 #include "strings.hpp"
 #include "gfx/gfx-util.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/obs-frame-graph.hpp"
 #include "util/util-logging.hpp"
 
 #include "warning-disable.hpp"
@@ -126,14 +127,17 @@ static constexpr std::string_view HELP_URL = "https://github.com/Xaymar/obs-Stre
 // TODO: Figure out a way to merge _lut_rt, _lut_texture, _rt_source, _rt_grad, _tex_source, _tex_grade, _source_updated and _grade_updated.
 // Seriously this is too much GPU space wasted on unused trash.
 
-color_grade_instance::~color_grade_instance() {}
+color_grade_instance::~color_grade_instance()
+{
+	_frame_graph.reset();
+}
 
 color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self)
-	: obs::source_instance(data, self), _effect(), _gfx_util(::streamfx::gfx::util::get()), _lift(), _gamma(), _gain(),
-	  _offset(), _tint_detection(), _tint_luma(), _tint_exponent(), _tint_low(), _tint_mid(), _tint_hig(),
-	  _correction(), _lut_enabled(true), _lut_depth(), _ccache_rt(), _ccache_texture(), _ccache_fresh(false),
-	  _lut_initialized(false), _lut_dirty(true), _lut_producer(), _lut_consumer(), _lut_rt(), _lut_texture(),
-	  _cache_rt(), _cache_texture(), _cache_fresh(false)
+	: obs::source_instance(data, self), _effect(), _effect_params(), _gfx_util(::streamfx::gfx::util::get()), _lift(),
+	  _gamma(), _gain(), _offset(), _tint_detection(), _tint_luma(), _tint_exponent(), _tint_low(), _tint_mid(),
+	  _tint_hig(), _correction(), _lut_enabled(true), _lut_depth(), _ccache_rt(), _ccache_texture(),
+	  _ccache_fresh(false), _lut_initialized(false), _lut_dirty(true), _lut_producer(), _lut_consumer(), _lut_rt(),
+	  _lut_texture(), _cache_rt(), _cache_texture(), _cache_fresh(false), _frame_graph()
 {
 	{
 		auto gctx = streamfx::obs::gs::context();
@@ -143,6 +147,20 @@ color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self)
 			auto file = streamfx::data_file_path("effects/color-grade.effect");
 			try {
 				_effect = streamfx::obs::gs::effect::create(file);
+
+				// Resolve the parameters once, instead of searching for them every frame.
+				_effect_params.lift           = _effect.get_parameter("pLift");
+				_effect_params.gamma          = _effect.get_parameter("pGamma");
+				_effect_params.gain           = _effect.get_parameter("pGain");
+				_effect_params.offset         = _effect.get_parameter("pOffset");
+				_effect_params.tint_detection = _effect.get_parameter("pTintDetection");
+				_effect_params.tint_mode      = _effect.get_parameter("pTintMode");
+				_effect_params.tint_exponent  = _effect.get_parameter("pTintExponent");
+				_effect_params.tint_low       = _effect.get_parameter("pTintLow");
+				_effect_params.tint_mid       = _effect.get_parameter("pTintMid");
+				_effect_params.tint_hig       = _effect.get_parameter("pTintHig");
+				_effect_params.correction     = _effect.get_parameter("pCorrection");
+				_effect_params.image          = _effect.get_parameter("image");
 			} catch (std::exception& ex) {
 				D_LOG_ERROR("Error loading '%s': %s", file.u8string().c_str(), ex.what());
 				throw;
@@ -169,6 +187,24 @@ color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self)
 	}
 
 	update(data);
+
+	if (auto graph = streamfx::obs::frame_graph::instance(); graph) {
+		_frame_graph = graph->add(_self, [this]() -> std::shared_ptr<streamfx::obs::gs::texture> {
+			obs_source_t* target = obs_filter_get_target(_self);
+			uint32_t      width  = obs_source_get_base_width(target);
+			uint32_t      height = obs_source_get_base_height(target);
+			if (!target || !width || !height) {
+				return nullptr;
+			}
+
+			try {
+				return render_output(width, height);
+			} catch (std::exception const& ex) {
+				D_LOG_ERROR("Failed to hand over output: %s", ex.what());
+				return nullptr;
+			}
+		});
+	}
 }
 
 void color_grade_instance::allocate_rendertarget(gs_color_format format)
@@ -246,51 +282,47 @@ void color_grade_instance::update(obs_data_t* data)
 
 void color_grade_instance::prepare_effect()
 {
-	if (auto p = _effect.get_parameter("pLift"); p) {
+	if (auto& p = _effect_params.lift; p) {
 		p.set_float4(_lift);
 	}
 
-	if (auto p = _effect.get_parameter("pGamma"); p) {
+	if (auto& p = _effect_params.gamma; p) {
 		p.set_float4(_gamma);
 	}
 
-	if (auto p = _effect.get_parameter("pGain"); p) {
+	if (auto& p = _effect_params.gain; p) {
 		p.set_float4(_gain);
 	}
 
-	if (auto p = _effect.get_parameter("pOffset"); p) {
+	if (auto& p = _effect_params.offset; p) {
 		p.set_float4(_offset);
 	}
 
-	if (auto p = _effect.get_parameter("pLift"); p) {
-		p.set_float4(_lift);
-	}
-
-	if (auto p = _effect.get_parameter("pTintDetection"); p) {
+	if (auto& p = _effect_params.tint_detection; p) {
 		p.set_int(static_cast<int32_t>(_tint_detection));
 	}
 
-	if (auto p = _effect.get_parameter("pTintMode"); p) {
+	if (auto& p = _effect_params.tint_mode; p) {
 		p.set_int(static_cast<int32_t>(_tint_luma));
 	}
 
-	if (auto p = _effect.get_parameter("pTintExponent"); p) {
+	if (auto& p = _effect_params.tint_exponent; p) {
 		p.set_float(_tint_exponent);
 	}
 
-	if (auto p = _effect.get_parameter("pTintLow"); p) {
+	if (auto& p = _effect_params.tint_low; p) {
 		p.set_float3(_tint_low);
 	}
 
-	if (auto p = _effect.get_parameter("pTintMid"); p) {
+	if (auto& p = _effect_params.tint_mid; p) {
 		p.set_float3(_tint_mid);
 	}
 
-	if (auto p = _effect.get_parameter("pTintHig"); p) {
+	if (auto& p = _effect_params.tint_hig; p) {
 		p.set_float3(_tint_hig);
 	}
 
-	if (auto p = _effect.get_parameter("pCorrection"); p) {
+	if (auto& p = _effect_params.correction; p) {
 		p.set_float4(_correction);
 	}
 }
@@ -316,7 +348,7 @@ void color_grade_instance::rebuild_lut()
 		prepare_effect();
 
 		// Assign texture.
-		if (auto p = _effect.get_parameter("image"); p) {
+		if (auto& p = _effect_params.image; p) {
 			p.set_texture(lut_texture);
 		}
 
@@ -362,7 +394,6 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 	obs_source_t* target = obs_filter_get_target(_self);
 	uint32_t      width  = obs_source_get_base_width(target);
 	uint32_t      height = obs_source_get_base_height(target);
-	vec4          blank  = vec4{0, 0, 0, 0};
 	shader               = shader ? shader : obs_get_base_effect(OBS_EFFECT_DEFAULT);
 
 	// Skip filter if anything is wrong.
@@ -371,19 +402,54 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 		return;
 	}
 
+	// 1. Capture the input and 2. apply the grade to it.
+	render_output(width, height);
+
+	// 3. Render the output cache.
+	{
+#ifdef ENABLE_PROFILING
+		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache_render, "Draw Cache"};
+#endif
+		// Revert GPU status to what OBS Studio expects.
+		gs_enable_depth_test(false);
+		gs_enable_color(true, true, true, true);
+		gs_set_cull_mode(GS_NEITHER);
+
+		// Draw the render cache.
+		while (gs_effect_loop(shader, "Draw")) {
+			gs_effect_set_texture(gs_effect_get_param_by_name(shader, "image"),
+								  _cache_texture ? _cache_texture->get_object() : nullptr);
+			gs_draw_sprite(nullptr, 0, width, height);
+		}
+	}
+}
+
+std::shared_ptr<streamfx::obs::gs::texture> color_grade_instance::render_output(uint32_t width, uint32_t height)
+{
+	vec4 blank = vec4{0, 0, 0, 0};
+
 #ifdef ENABLE_PROFILING
 	streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_source, "Color Grading '%s'",
 										 obs_source_get_name(_self)};
 #endif
 
+	// 1. Take the output of the filter above as is, if it is able to hand it over.
+	if (!_ccache_fresh || !_ccache_texture) {
+		if (auto graph = streamfx::obs::frame_graph::instance(); graph) {
+			if (_ccache_texture = graph->input(_self, width, height); _ccache_texture) {
+				_ccache_fresh = true;
+			}
+		}
+	}
+
 	// TODO: Optimize this once (https://github.com/obsproject/obs-studio/pull/4199) is merged.
 	// - We can skip the original capture and reduce the overall impact of this.
 
-	// 1. Capture the filter/source rendered above this.
+	// 1. Otherwise capture the filter/source rendered above this.
 	if (!_ccache_fresh || !_ccache_texture) {
 #ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_cache, "Cache '%s'",
-											 obs_source_get_name(target)};
+											 obs_source_get_name(obs_filter_get_target(_self))};
 #endif
 		// If the input cache render target doesn't exist, create it.
 		if (!_ccache_rt) {
@@ -538,7 +604,7 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 			gs_set_cull_mode(GS_NEITHER);
 
 			// Render the effect.
-			_effect.get_parameter("image").set_texture(_ccache_texture);
+			_effect_params.image.set_texture(_ccache_texture);
 			while (gs_effect_loop(_effect.get_object(), "Draw")) {
 				_gfx_util->draw_fullscreen_triangle();
 			}
@@ -557,23 +623,7 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 		throw std::runtime_error("Failed to cache processed source.");
 	}
 
-	// 3. Render the output cache.
-	{
-#ifdef ENABLE_PROFILING
-		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache_render, "Draw Cache"};
-#endif
-		// Revert GPU status to what OBS Studio expects.
-		gs_enable_depth_test(false);
-		gs_enable_color(true, true, true, true);
-		gs_set_cull_mode(GS_NEITHER);
-
-		// Draw the render cache.
-		while (gs_effect_loop(shader, "Draw")) {
-			gs_effect_set_texture(gs_effect_get_param_by_name(shader, "image"),
-								  _cache_texture ? _cache_texture->get_object() : nullptr);
-			gs_draw_sprite(nullptr, 0, width, height);
-		}
-	}
+	return _cache_texture;
 }
 
 color_grade_factory::color_grade_factory()
@@ -48,7 +48,21 @@ namespace streamfx::filter::color_grade {
 	};
 
 	class color_grade_instance : public obs::source_instance {
-		streamfx::obs::gs::effect            _effect;
+		streamfx::obs::gs::effect _effect;
+		struct {
+			streamfx::obs::gs::effect_parameter lift;
+			streamfx::obs::gs::effect_parameter gamma;
+			streamfx::obs::gs::effect_parameter gain;
+			streamfx::obs::gs::effect_parameter offset;
+			streamfx::obs::gs::effect_parameter tint_detection;
+			streamfx::obs::gs::effect_parameter tint_mode;
+			streamfx::obs::gs::effect_parameter tint_exponent;
+			streamfx::obs::gs::effect_parameter tint_low;
+			streamfx::obs::gs::effect_parameter tint_mid;
+			streamfx::obs::gs::effect_parameter tint_hig;
+			streamfx::obs::gs::effect_parameter correction;
+			streamfx::obs::gs::effect_parameter image;
+		} _effect_params;
 		std::shared_ptr<streamfx::gfx::util> _gfx_util;
 
 		// User Configuration
@@ -84,6 +98,8 @@ namespace streamfx::filter::color_grade {
 		std::shared_ptr<streamfx::obs::gs::texture>      _cache_texture;
 		bool                                             _cache_fresh;
 
+		std::shared_ptr<void> _frame_graph;
+
 		public:
 		color_grade_instance(obs_data_t* data, obs_source_t* self);
 		virtual ~color_grade_instance();
@@ -100,6 +116,9 @@ namespace streamfx::filter::color_grade {
 
 		virtual void video_tick(float_t time) override;
 		virtual void video_render(gs_effect_t* effect) override;
+
+		private:
+		std::shared_ptr<streamfx::obs::gs::texture> render_output(uint32_t width, uint32_t height);
 	};
 
 	class color_grade_factory : public obs::source_factory<filter::color_grade::color_grade_factory,
@@ -83,9 +83,12 @@ namespace streamfx::filter::denoising {
 		void video_tick(float_t time) override;
 		void video_render(gs_effect_t* effect) override;
 
+		void statistics(obs_data_t* data) override;
+
 		private:
 		void switch_provider(denoising_provider provider);
 		void task_switch_provider(util::threadpool::task_data_t data);
+		void task_provider_switched(util::threadpool::task_data_t data);
 
 #ifdef ENABLE_FILTER_DENOISING_NVIDIA
 		void nvvfx_denoising_load();
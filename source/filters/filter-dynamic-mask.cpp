@@ -395,10 +395,10 @@ void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
 				_base_rt->get_texture(_base_tex);
 			} catch (const std::exception& ex) {
 				_self.process_filter_end(default_effect, width, height);
-				DLOG_ERROR("Failed to capture base texture: %s", ex.what());
+				P_LOG_ERROR_LIMITED("Failed to capture base texture: %s", ex.what());
 			} catch (...) {
 				_self.process_filter_end(default_effect, width, height);
-				DLOG_ERROR("Failed to capture base texture.", nullptr);
+				P_LOG_ERROR_LIMITED("Failed to capture base texture.", nullptr);
 			}
 		}
 
@@ -477,9 +477,9 @@ void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
 				_have_input = true;
 				_input_rt->get_texture(_input_tex);
 			} catch (const std::exception& ex) {
-				DLOG_ERROR("Failed to capture input texture: %s", ex.what());
+				P_LOG_ERROR_LIMITED("Failed to capture input texture: %s", ex.what());
 			} catch (...) {
-				DLOG_ERROR("Failed to capture input texture.", nullptr);
+				P_LOG_ERROR_LIMITED("Failed to capture input texture.", nullptr);
 			}
 
 			gs_enable_framebuffer_srgb(previous_srgb);
@@ -559,9 +559,9 @@ void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
 			_final_tex  = _final_rt->get_texture();
 			_have_final = true;
 		} catch (const std::exception& ex) {
-			DLOG_ERROR("Failed to render final texture: %s", ex.what());
+			P_LOG_ERROR_LIMITED("Failed to render final texture: %s", ex.what());
 		} catch (...) {
-			DLOG_ERROR("Failed to render final texture.", nullptr);
+			P_LOG_ERROR_LIMITED("Failed to render final texture.", nullptr);
 		}
 
 		gs_set_linear_srgb(previous_lsrgb);
@@ -608,7 +608,7 @@ void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
 		gs_effect_t* final_effect = in_effect ? in_effect : default_effect;
 		gs_eparam_t* param        = gs_effect_get_param_by_name(final_effect, "image");
 		if (!param) {
-			DLOG_ERROR("<filter-dynamic-mask:%s> Failed to set image param.", obs_source_get_name(_self));
+			P_LOG_ERROR_LIMITED("<filter-dynamic-mask:%s> Failed to set image param.", obs_source_get_name(_self));
 			gs_enable_framebuffer_srgb(previous_srgb);
 			obs_source_skip_video_filter(_self);
 			return;
@@ -753,22 +753,18 @@ obs_properties_t* dynamic_mask_factory::get_properties2(dynamic_mask_instance* d
 		p = obs_properties_add_list(props, ST_KEY_INPUT, D_TRANSLATE(ST_I18N_INPUT), OBS_COMBO_TYPE_LIST,
 									OBS_COMBO_FORMAT_STRING);
 		obs_property_list_add_string(p, "", "");
-		obs::source_tracker::get()->enumerate(
-			[&p](std::string name, obs_source_t*) {
-				std::stringstream sstr;
-				sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SOURCE) << ")";
-				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
-				return false;
-			},
-			obs::source_tracker::filter_video_sources);
-		obs::source_tracker::get()->enumerate(
-			[&p](std::string name, obs_source_t*) {
-				std::stringstream sstr;
-				sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SCENE) << ")";
-				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
-				return false;
-			},
-			obs::source_tracker::filter_scenes);
+		auto video_sources = obs::source_tracker::get()->names(obs::source_tracker::category::VIDEO);
+		for (auto& name : *video_sources) {
+			std::stringstream sstr;
+			sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SOURCE) << ")";
+			obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
+		}
+		auto scenes = obs::source_tracker::get()->names(obs::source_tracker::category::SCENE);
+		for (auto& name : *scenes) {
+			std::stringstream sstr;
+			sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SCENE) << ")";
+			obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
+		}
 	}
 
 	const char* pri_chs[] = {S_CHANNEL_RED, S_CHANNEL_GREEN, S_CHANNEL_BLUE, S_CHANNEL_ALPHA};
@@ -20,6 +20,7 @@
 #include "filter-sdf-effects.hpp"
 #include "strings.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/obs-frame-graph.hpp"
 #include "util/util-logging.hpp"
 
 #include "warning-disable.hpp"
@@ -150,12 +151,35 @@ sdf_effects_instance::sdf_effects_instance(obs_data_t* settings, obs_source_t* s
 		for (auto& kv : load_arr) {
 			auto file = streamfx::data_file_path(kv.first);
 			try {
-				kv.second = streamfx::obs::gs::effect::create(file);
+				kv.second = streamfx::obs::gs::effect::create_shared(file);
 			} catch (std::exception& ex) {
 				D_LOG_ERROR("Error loading '%s': %s", file.u8string().c_str(), ex.what());
 				throw;
 			}
 		}
+
+		// Resolve the parameters once, instead of searching for them every frame.
+		_sdf_producer_params.image     = _sdf_producer_effect.get_parameter("_image");
+		_sdf_producer_params.size      = _sdf_producer_effect.get_parameter("_size");
+		_sdf_producer_params.sdf       = _sdf_producer_effect.get_parameter("_sdf");
+		_sdf_producer_params.threshold = _sdf_producer_effect.get_parameter("_threshold");
+
+		_sdf_consumer_params.sdf_texture               = _sdf_consumer_effect.get_parameter("pSDFTexture");
+		_sdf_consumer_params.sdf_threshold             = _sdf_consumer_effect.get_parameter("pSDFThreshold");
+		_sdf_consumer_params.image_texture             = _sdf_consumer_effect.get_parameter("pImageTexture");
+		_sdf_consumer_params.shadow_color              = _sdf_consumer_effect.get_parameter("pShadowColor");
+		_sdf_consumer_params.shadow_min                = _sdf_consumer_effect.get_parameter("pShadowMin");
+		_sdf_consumer_params.shadow_max                = _sdf_consumer_effect.get_parameter("pShadowMax");
+		_sdf_consumer_params.shadow_offset             = _sdf_consumer_effect.get_parameter("pShadowOffset");
+		_sdf_consumer_params.glow_color                = _sdf_consumer_effect.get_parameter("pGlowColor");
+		_sdf_consumer_params.glow_width                = _sdf_consumer_effect.get_parameter("pGlowWidth");
+		_sdf_consumer_params.glow_sharpness            = _sdf_consumer_effect.get_parameter("pGlowSharpness");
+		_sdf_consumer_params.glow_sharpness_inverse    = _sdf_consumer_effect.get_parameter("pGlowSharpnessInverse");
+		_sdf_consumer_params.outline_color             = _sdf_consumer_effect.get_parameter("pOutlineColor");
+		_sdf_consumer_params.outline_width             = _sdf_consumer_effect.get_parameter("pOutlineWidth");
+		_sdf_consumer_params.outline_offset            = _sdf_consumer_effect.get_parameter("pOutlineOffset");
+		_sdf_consumer_params.outline_sharpness         = _sdf_consumer_effect.get_parameter("pOutlineSharpness");
+		_sdf_consumer_params.outline_sharpness_inverse = _sdf_consumer_effect.get_parameter("pOutlineSharpnessInverse");
 	}
 
 	update(settings);
@@ -353,23 +377,31 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 		gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
 		if (!_source_rendered) {
+			// Take the output of the filter above as is, if it is able to hand it over.
+			_source_texture.reset();
+			if (auto graph = streamfx::obs::frame_graph::instance(); graph) {
+				_source_texture = graph->input(_self, baseW, baseH);
+			}
+
 			// Store input texture.
-			{
+			if (!_source_texture) {
+				{
 #ifdef ENABLE_PROFILING
-				streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
+					streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
 #endif
 
-				auto op = _source_rt->render(baseW, baseH);
-				gs_ortho(0, static_cast<float>(baseW), 0, static_cast<float>(baseH), -1, 1);
-				gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
+					auto op = _source_rt->render(baseW, baseH);
+					gs_ortho(0, static_cast<float>(baseW), 0, static_cast<float>(baseH), -1, 1);
+					gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
 
-				if (obs_source_process_filter_begin(_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING)) {
-					obs_source_process_filter_end(_self, final_effect, baseW, baseH);
-				} else {
-					throw std::runtime_error("failed to process source");
+					if (obs_source_process_filter_begin(_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING)) {
+						obs_source_process_filter_end(_self, final_effect, baseW, baseH);
+					} else {
+						throw std::runtime_error("failed to process source");
+					}
 				}
+				_source_rt->get_texture(_source_texture);
 			}
-			_source_rt->get_texture(_source_texture);
 			if (!_source_texture) {
 				throw std::runtime_error("failed to draw source");
 			}
@@ -406,10 +438,10 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 					gs_ortho(0, 1, 0, 1, -1, 1);
 					gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
 
-					_sdf_producer_effect.get_parameter("_image").set_texture(_source_texture);
-					_sdf_producer_effect.get_parameter("_size").set_float2(float_t(sdfW), float_t(sdfH));
-					_sdf_producer_effect.get_parameter("_sdf").set_texture(_sdf_texture);
-					_sdf_producer_effect.get_parameter("_threshold").set_float(_sdf_threshold);
+					_sdf_producer_params.image.set_texture(_source_texture);
+					_sdf_producer_params.size.set_float2(float_t(sdfW), float_t(sdfH));
+					_sdf_producer_params.sdf.set_texture(_sdf_texture);
+					_sdf_producer_params.threshold.set_float(_sdf_threshold);
 
 					while (gs_effect_loop(_sdf_producer_effect.get_object(), "Draw")) {
 						_gfx_util->draw_fullscreen_triangle();
@@ -476,64 +508,64 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 			gs_enable_blending(true);
 			gs_blend_function_separate(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA, GS_BLEND_ONE, GS_BLEND_ONE);
 			if (_outer_shadow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pShadowColor").set_float4(_outer_shadow_color);
-				_sdf_consumer_effect.get_parameter("pShadowMin").set_float(_outer_shadow_range_min);
-				_sdf_consumer_effect.get_parameter("pShadowMax").set_float(_outer_shadow_range_max);
-				_sdf_consumer_effect.get_parameter("pShadowOffset")
+				_sdf_consumer_params.sdf_texture.set_texture(_sdf_texture);
+				_sdf_consumer_params.sdf_threshold.set_float(_sdf_threshold);
+				_sdf_consumer_params.image_texture.set_texture(_source_texture->get_object());
+				_sdf_consumer_params.shadow_color.set_float4(_outer_shadow_color);
+				_sdf_consumer_params.shadow_min.set_float(_outer_shadow_range_min);
+				_sdf_consumer_params.shadow_max.set_float(_outer_shadow_range_max);
+				_sdf_consumer_params.shadow_offset
 					.set_float2(_outer_shadow_offset_x / float_t(baseW), _outer_shadow_offset_y / float_t(baseH));
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "ShadowOuter")) {
 					_gfx_util->draw_fullscreen_triangle();
 				}
 			}
 			if (_inner_shadow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pShadowColor").set_float4(_inner_shadow_color);
-				_sdf_consumer_effect.get_parameter("pShadowMin").set_float(_inner_shadow_range_min);
-				_sdf_consumer_effect.get_parameter("pShadowMax").set_float(_inner_shadow_range_max);
-				_sdf_consumer_effect.get_parameter("pShadowOffset")
+				_sdf_consumer_params.sdf_texture.set_texture(_sdf_texture);
+				_sdf_consumer_params.sdf_threshold.set_float(_sdf_threshold);
+				_sdf_consumer_params.image_texture.set_texture(_source_texture->get_object());
+				_sdf_consumer_params.shadow_color.set_float4(_inner_shadow_color);
+				_sdf_consumer_params.shadow_min.set_float(_inner_shadow_range_min);
+				_sdf_consumer_params.shadow_max.set_float(_inner_shadow_range_max);
+				_sdf_consumer_params.shadow_offset
 					.set_float2(_inner_shadow_offset_x / float_t(baseW), _inner_shadow_offset_y / float_t(baseH));
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "ShadowInner")) {
 					_gfx_util->draw_fullscreen_triangle();
 				}
 			}
 			if (_outer_glow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pGlowColor").set_float4(_outer_glow_color);
-				_sdf_consumer_effect.get_parameter("pGlowWidth").set_float(_outer_glow_width);
-				_sdf_consumer_effect.get_parameter("pGlowSharpness").set_float(_outer_glow_sharpness);
-				_sdf_consumer_effect.get_parameter("pGlowSharpnessInverse").set_float(_outer_glow_sharpness_inv);
+				_sdf_consumer_params.sdf_texture.set_texture(_sdf_texture);
+				_sdf_consumer_params.sdf_threshold.set_float(_sdf_threshold);
+				_sdf_consumer_params.image_texture.set_texture(_source_texture->get_object());
+				_sdf_consumer_params.glow_color.set_float4(_outer_glow_color);
+				_sdf_consumer_params.glow_width.set_float(_outer_glow_width);
+				_sdf_consumer_params.glow_sharpness.set_float(_outer_glow_sharpness);
+				_sdf_consumer_params.glow_sharpness_inverse.set_float(_outer_glow_sharpness_inv);
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "GlowOuter")) {
 					_gfx_util->draw_fullscreen_triangle();
 				}
 			}
 			if (_inner_glow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pGlowColor").set_float4(_inner_glow_color);
-				_sdf_consumer_effect.get_parameter("pGlowWidth").set_float(_inner_glow_width);
-				_sdf_consumer_effect.get_parameter("pGlowSharpness").set_float(_inner_glow_sharpness);
-				_sdf_consumer_effect.get_parameter("pGlowSharpnessInverse").set_float(_inner_glow_sharpness_inv);
+				_sdf_consumer_params.sdf_texture.set_texture(_sdf_texture);
+				_sdf_consumer_params.sdf_threshold.set_float(_sdf_threshold);
+				_sdf_consumer_params.image_texture.set_texture(_source_texture->get_object());
+				_sdf_consumer_params.glow_color.set_float4(_inner_glow_color);
+				_sdf_consumer_params.glow_width.set_float(_inner_glow_width);
+				_sdf_consumer_params.glow_sharpness.set_float(_inner_glow_sharpness);
+				_sdf_consumer_params.glow_sharpness_inverse.set_float(_inner_glow_sharpness_inv);
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "GlowInner")) {
 					_gfx_util->draw_fullscreen_triangle();
 				}
 			}
 			if (_outline) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pOutlineColor").set_float4(_outline_color);
-				_sdf_consumer_effect.get_parameter("pOutlineWidth").set_float(_outline_width);
-				_sdf_consumer_effect.get_parameter("pOutlineOffset").set_float(_outline_offset);
-				_sdf_consumer_effect.get_parameter("pOutlineSharpness").set_float(_outline_sharpness);
-				_sdf_consumer_effect.get_parameter("pOutlineSharpnessInverse").set_float(_outline_sharpness_inv);
+				_sdf_consumer_params.sdf_texture.set_texture(_sdf_texture);
+				_sdf_consumer_params.sdf_threshold.set_float(_sdf_threshold);
+				_sdf_consumer_params.image_texture.set_texture(_source_texture->get_object());
+				_sdf_consumer_params.outline_color.set_float4(_outline_color);
+				_sdf_consumer_params.outline_width.set_float(_outline_width);
+				_sdf_consumer_params.outline_offset.set_float(_outline_offset);
+				_sdf_consumer_params.outline_sharpness.set_float(_outline_sharpness);
+				_sdf_consumer_params.outline_sharpness_inverse.set_float(_outline_sharpness_inv);
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "Outline")) {
 					_gfx_util->draw_fullscreen_triangle();
 				}
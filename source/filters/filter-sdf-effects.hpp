@@ -33,6 +33,32 @@ namespace streamfx::filter::sdf_effects {
 		streamfx::obs::gs::effect            _sdf_consumer_effect;
 		std::shared_ptr<streamfx::gfx::util> _gfx_util;
 
+		// Effect Parameters
+		struct {
+			streamfx::obs::gs::effect_parameter image;
+			streamfx::obs::gs::effect_parameter size;
+			streamfx::obs::gs::effect_parameter sdf;
+			streamfx::obs::gs::effect_parameter threshold;
+		} _sdf_producer_params;
+		struct {
+			streamfx::obs::gs::effect_parameter sdf_texture;
+			streamfx::obs::gs::effect_parameter sdf_threshold;
+			streamfx::obs::gs::effect_parameter image_texture;
+			streamfx::obs::gs::effect_parameter shadow_color;
+			streamfx::obs::gs::effect_parameter shadow_min;
+			streamfx::obs::gs::effect_parameter shadow_max;
+			streamfx::obs::gs::effect_parameter shadow_offset;
+			streamfx::obs::gs::effect_parameter glow_color;
+			streamfx::obs::gs::effect_parameter glow_width;
+			streamfx::obs::gs::effect_parameter glow_sharpness;
+			streamfx::obs::gs::effect_parameter glow_sharpness_inverse;
+			streamfx::obs::gs::effect_parameter outline_color;
+			streamfx::obs::gs::effect_parameter outline_width;
+			streamfx::obs::gs::effect_parameter outline_offset;
+			streamfx::obs::gs::effect_parameter outline_sharpness;
+			streamfx::obs::gs::effect_parameter outline_sharpness_inverse;
+		} _sdf_consumer_params;
+
 		// Input
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _source_rt;
 		std::shared_ptr<streamfx::obs::gs::texture>      _source_texture;
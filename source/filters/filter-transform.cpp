@@ -20,6 +20,7 @@
 #include "filter-transform.hpp"
 #include "strings.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/obs-frame-graph.hpp"
 #include "util/util-logging.hpp"
 
 #include "warning-disable.hpp"
@@ -425,40 +426,51 @@ void transform_instance::video_render(gs_effect_t* effect)
 	}
 
 	if (!_cache_rendered) {
+		// Take the output of the filter above as is, if it is able to hand it over and no padding is needed.
+		_cache_texture.reset();
+		if ((cache_width == base_width) && (cache_height == base_height)) {
+			if (auto graph = streamfx::obs::frame_graph::instance(); graph) {
+				_cache_texture = graph->input(_self, base_width, base_height);
+			}
+		}
+
+		if (!_cache_texture) {
 #ifdef ENABLE_PROFILING
-		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
+			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
 #endif
 
-		auto op = _cache_rt->render(cache_width, cache_height);
+			auto op = _cache_rt->render(cache_width, cache_height);
 
-		gs_ortho(0, static_cast<float>(base_width), 0, static_cast<float>(base_height), -1, 1);
+			gs_ortho(0, static_cast<float>(base_width), 0, static_cast<float>(base_height), -1, 1);
 
-		vec4 clear_color = {0, 0, 0, 0};
-		gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &clear_color, 0, 0);
+			vec4 clear_color = {0, 0, 0, 0};
+			gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &clear_color, 0, 0);
 
-		/// Render original source
-		if (obs_source_process_filter_begin(_self, GS_RGBA, OBS_NO_DIRECT_RENDERING)) {
-			gs_blend_state_push();
-			gs_reset_blend_state();
-			gs_enable_blending(false);
-			gs_blend_function_separate(GS_BLEND_ONE, GS_BLEND_ZERO, GS_BLEND_SRCALPHA, GS_BLEND_ZERO);
-			gs_enable_depth_test(false);
-			gs_enable_stencil_test(false);
-			gs_enable_stencil_write(false);
-			gs_enable_color(true, true, true, true);
-			gs_set_cull_mode(GS_NEITHER);
-
-			obs_source_process_filter_end(_self, default_effect, base_width, base_height);
-
-			gs_blend_state_pop();
-		} else {
-			obs_source_skip_video_filter(_self);
-			return;
+			/// Render original source
+			if (obs_source_process_filter_begin(_self, GS_RGBA, OBS_NO_DIRECT_RENDERING)) {
+				gs_blend_state_push();
+				gs_reset_blend_state();
+				gs_enable_blending(false);
+				gs_blend_function_separate(GS_BLEND_ONE, GS_BLEND_ZERO, GS_BLEND_SRCALPHA, GS_BLEND_ZERO);
+				gs_enable_depth_test(false);
+				gs_enable_stencil_test(false);
+				gs_enable_stencil_write(false);
+				gs_enable_color(true, true, true, true);
+				gs_set_cull_mode(GS_NEITHER);
+
+				obs_source_process_filter_end(_self, default_effect, base_width, base_height);
+
+				gs_blend_state_pop();
+			} else {
+				obs_source_skip_video_filter(_self);
+				return;
+			}
+
+			_cache_rt->get_texture(_cache_texture);
 		}
 
 		_cache_rendered = true;
 	}
-	_cache_rt->get_texture(_cache_texture);
 	if (!_cache_texture) {
 		obs_source_skip_video_filter(_self);
 		return;
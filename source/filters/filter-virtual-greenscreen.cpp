@@ -138,16 +138,15 @@ virtual_greenscreen_instance::~virtual_greenscreen_instance()
 {
 	D_LOG_DEBUG("Finalizing... (Addr: 0x%" PRIuPTR ")", this);
 
+	// Wait for any pending provider switches, as they need the lock themselves.
+	if (_provider_task) {
+		_provider_task->await_completion();
+		_provider_task.reset();
+	}
+
 	{ // Unload the underlying effect ASAP.
 		std::unique_lock<std::mutex> ul(_provider_lock);
 
-		// De-queue the underlying task.
-		if (_provider_task) {
-			streamfx::threadpool()->pop(_provider_task);
-			_provider_task->await_completion();
-			_provider_task.reset();
-		}
-
 		// TODO: Make this asynchronous.
 		switch (_provider) {
 #ifdef ENABLE_FILTER_VIRTUAL_GREENSCREEN_NVIDIA
@@ -361,8 +360,21 @@ void virtual_greenscreen_instance::video_render(gs_effect_t* effect)
 	}
 }
 
+void virtual_greenscreen_instance::statistics(obs_data_t* data)
+{
+	std::unique_lock<std::mutex> ul(_provider_lock, std::try_to_lock);
+	if (ul.owns_lock()) {
+		obs_data_set_string(data, "provider", cstring(_provider));
+	} else {
+		obs_data_set_string(data, "provider", "switching");
+	}
+	obs_data_set_bool(data, "provider_ready", _provider_ready);
+}
+
 struct switch_provider_data_t {
 	virtual_greenscreen_provider provider;
+	virtual_greenscreen_provider target;
+	bool                         loaded;
 };
 
 void streamfx::filter::virtual_greenscreen::virtual_greenscreen_instance::switch_provider(
@@ -375,34 +387,27 @@ void streamfx::filter::virtual_greenscreen::virtual_greenscreen_instance::switch
 		return;
 	}
 
-	// This doesn't work correctly.
-	// - Need to allow multiple switches at once because OBS is weird.
-	// - Doesn't guarantee that the task is properly killed off.
-
 	// Log information.
 	D_LOG_INFO("Instance '%s' is switching provider from '%s' to '%s'.", obs_source_get_name(_self), cstring(_provider),
 			   cstring(provider));
 
-	// If there is an existing task, attempt to cancel it.
-	if (_provider_task) {
-		// De-queue it.
-		streamfx::threadpool()->pop(_provider_task);
-
-		// Await the death of the task itself.
-		_provider_task->await_completion();
-
-		// Clear any memory associated with it.
-		_provider_task.reset();
-	}
+	// Stop using the current provider right away.
+	_provider_ready = false;
 
 	// Build data to pass into the task.
 	auto spd      = std::make_shared<switch_provider_data_t>();
 	spd->provider = _provider;
+	spd->target   = provider;
+	spd->loaded   = false;
 	_provider     = provider;
 
-	// Then spawn a new task to switch provider.
-	_provider_task = streamfx::threadpool()->push(
-		std::bind(&virtual_greenscreen_instance::task_switch_provider, this, std::placeholders::_1), spd);
+	// Queue the switch behind any switch that is still in progress, instead of cancelling and waiting for it while
+	// holding the lock. Without a previous task, this queues it immediately. Once the switch is done, the
+	// continuation hands the new provider over to rendering.
+	auto task      = streamfx::threadpool()->then(
+		_provider_task, std::bind(&virtual_greenscreen_instance::task_switch_provider, this, std::placeholders::_1), spd);
+	_provider_task = streamfx::threadpool()->then(
+		task, std::bind(&virtual_greenscreen_instance::task_provider_switched, this, std::placeholders::_1), spd);
 }
 
 void streamfx::filter::virtual_greenscreen::virtual_greenscreen_instance::task_switch_provider(
@@ -429,15 +434,10 @@ void streamfx::filter::virtual_greenscreen::virtual_greenscreen_instance::task_s
 		}
 
 		// Load the new provider.
-		switch (_provider) {
+		switch (spd->target) {
 #ifdef ENABLE_FILTER_VIRTUAL_GREENSCREEN_NVIDIA
 		case virtual_greenscreen_provider::NVIDIA_GREENSCREEN:
 			nvvfxgs_load();
-			{
-				auto data = obs_source_get_settings(_self);
-				nvvfxgs_update(data);
-				obs_data_release(data);
-			}
 			break;
 #endif
 		default:
@@ -446,9 +446,41 @@ void streamfx::filter::virtual_greenscreen::virtual_greenscreen_instance::task_s
 
 		// Log information.
 		D_LOG_INFO("Instance '%s' switched provider from '%s' to '%s'.", obs_source_get_name(_self),
-				   cstring(spd->provider), cstring(_provider));
+				   cstring(spd->provider), cstring(spd->target));
+
+		spd->loaded = true;
+	} catch (std::exception const& ex) {
+		// Log information.
+		D_LOG_ERROR("Instance '%s' failed switching provider with error: %s", obs_source_get_name(_self), ex.what());
+	}
+}
+
+void streamfx::filter::virtual_greenscreen::virtual_greenscreen_instance::task_provider_switched(util::threadpool::task_data_t data)
+{
+	std::shared_ptr<switch_provider_data_t> spd = std::static_pointer_cast<switch_provider_data_t>(data);
+
+	std::unique_lock<std::mutex> ul(_provider_lock);
+
+	// Skip providers that failed to load, or that were replaced by another switch in the meantime.
+	if (!spd->loaded || (spd->target != _provider)) {
+		return;
+	}
+
+	try {
+		// Settings changed during the switch were skipped by update(), so apply the current ones.
+		auto settings =
+			std::shared_ptr<obs_data_t>(obs_source_get_settings(_self), [](obs_data_t* p) { obs_data_release(p); });
+		switch (_provider) {
+#ifdef ENABLE_FILTER_VIRTUAL_GREENSCREEN_NVIDIA
+		case virtual_greenscreen_provider::NVIDIA_GREENSCREEN:
+			nvvfxgs_update(settings.get());
+			break;
+#endif
+		default:
+			break;
+		}
 
-		// Set the new provider as valid.
+		// Rendering picks up the new provider from here on.
 		_provider_ready = true;
 	} catch (std::exception const& ex) {
 		// Log information.
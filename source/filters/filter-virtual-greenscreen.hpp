@@ -84,9 +84,12 @@ namespace streamfx::filter::virtual_greenscreen {
 		void video_tick(float_t time) override;
 		void video_render(gs_effect_t* effect) override;
 
+		void statistics(obs_data_t* data) override;
+
 		private:
 		void switch_provider(virtual_greenscreen_provider provider);
 		void task_switch_provider(util::threadpool::task_data_t data);
+		void task_provider_switched(util::threadpool::task_data_t data);
 
 #ifdef ENABLE_FILTER_VIRTUAL_GREENSCREEN_NVIDIA
 		void nvvfxgs_load();
@@ -21,6 +21,14 @@
 #include <stdexcept>
 #include "warning-enable.hpp"
 
+streamfx::gfx::blur::effect_parameters::effect_parameters(::streamfx::obs::gs::effect& effect)
+	: image(effect.get_parameter("pImage")), image_size(effect.get_parameter("pImageSize")),
+	  image_texel(effect.get_parameter("pImageTexel")), step_scale(effect.get_parameter("pStepScale")),
+	  size(effect.get_parameter("pSize")), size_inverse_mul(effect.get_parameter("pSizeInverseMul")),
+	  kernel(effect.get_parameter("pKernel")), angle(effect.get_parameter("pAngle")),
+	  center(effect.get_parameter("pCenter"))
+{}
+
 void streamfx::gfx::blur::base::set_step_scale_x(double_t v)
 {
 	this->set_step_scale(v, this->get_step_scale_y());
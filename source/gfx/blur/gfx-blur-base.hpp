@@ -17,6 +17,7 @@
 
 #pragma once
 #include "common.hpp"
+#include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-texture.hpp"
 
 namespace streamfx::gfx {
@@ -29,6 +30,25 @@ namespace streamfx::gfx {
 			Zoom,
 		};
 
+		/** Parameters used by the blur effects, resolved once when the effect is loaded.
+		 *
+		 * Parameters that an effect does not have are left empty.
+		 */
+		struct effect_parameters {
+			::streamfx::obs::gs::effect_parameter image;
+			::streamfx::obs::gs::effect_parameter image_size;
+			::streamfx::obs::gs::effect_parameter image_texel;
+			::streamfx::obs::gs::effect_parameter step_scale;
+			::streamfx::obs::gs::effect_parameter size;
+			::streamfx::obs::gs::effect_parameter size_inverse_mul;
+			::streamfx::obs::gs::effect_parameter kernel;
+			::streamfx::obs::gs::effect_parameter angle;
+			::streamfx::obs::gs::effect_parameter center;
+
+			effect_parameters() = default;
+			effect_parameters(::streamfx::obs::gs::effect& effect);
+		};
+
 		class base {
 			public:
 			virtual ~base() {}
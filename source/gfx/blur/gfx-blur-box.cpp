@@ -18,6 +18,7 @@
 #include "gfx-blur-box.hpp"
 #include "common.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "plugin.hpp"
 
 #include "warning-disable.hpp"
@@ -35,6 +36,7 @@ streamfx::gfx::blur::box_data::box_data() : _gfx_util(::streamfx::gfx::util::get
 		auto file = streamfx::data_file_path("effects/blur/box.effect");
 		try {
 			_effect = streamfx::obs::gs::effect::create(file);
+			_parameters = ::streamfx::gfx::blur::effect_parameters(_effect);
 		} catch (const std::exception& ex) {
 			DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
 		}
@@ -44,6 +46,7 @@ streamfx::gfx::blur::box_data::box_data() : _gfx_util(::streamfx::gfx::util::get
 streamfx::gfx::blur::box_data::~box_data()
 {
 	auto gctx = streamfx::obs::gs::context();
+	_parameters = ::streamfx::gfx::blur::effect_parameters();
 	_effect.reset();
 }
 
@@ -57,6 +60,11 @@ streamfx::obs::gs::effect streamfx::gfx::blur::box_data::get_effect()
 	return _effect;
 }
 
+streamfx::gfx::blur::effect_parameters& streamfx::gfx::blur::box_data::get_parameters()
+{
+	return _parameters;
+}
+
 streamfx::gfx::blur::box_factory::box_factory() {}
 
 streamfx::gfx::blur::box_factory::~box_factory() {}
@@ -198,9 +206,8 @@ std::shared_ptr<::streamfx::gfx::blur::box_data> streamfx::gfx::blur::box_factor
 streamfx::gfx::blur::box::box()
 	: _data(::streamfx::gfx::blur::box_factory::get().data()), _size(1.), _step_scale({1., 1.})
 {
-	auto gctx      = streamfx::obs::gs::context();
-	_rendertarget  = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	auto gctx     = streamfx::obs::gs::context();
+	_rendertarget = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 streamfx::gfx::blur::box::~box() {}
@@ -278,20 +285,25 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 
 	// Two Pass Blur
 	streamfx::obs::gs::effect effect = _data->get_effect();
+	auto&                     params = _data->get_parameters();
 	if (effect) {
+		// Only the result has to outlive this render, the intermediate pass can use a shared render target.
+		auto temporary =
+			::streamfx::obs::gs::rendertarget_pool::lease(uint32_t(width), uint32_t(height), GS_RGBA, GS_ZS_NONE);
+
 		// Pass 1
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), 0.f);
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		params.image.set_texture(_input_texture);
+		params.image_texel.set_float2(float_t(1.f / width), 0.f);
+		params.step_scale.set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		params.size.set_float(float_t(_size));
+		params.size_inverse_mul.set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
 
 		{
 #ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = temporary->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				_data->get_gfx_util()->draw_fullscreen_triangle();
@@ -299,8 +311,8 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 		}
 
 		// Pass 2
-		effect.get_parameter("pImage").set_texture(_rendertarget2->get_texture());
-		effect.get_parameter("pImageTexel").set_float2(0.f, float_t(1.f / height));
+		params.image.set_texture(temporary->get_texture());
+		params.image_texel.set_float2(0.f, float_t(1.f / height));
 
 		{
 #ifdef ENABLE_PROFILING
@@ -368,13 +380,13 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_direction
 
 	// One Pass Blur
 	streamfx::obs::gs::effect effect = _data->get_effect();
+	auto&                     params = _data->get_parameters();
 	if (effect) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel")
-			.set_float2(float_t(1. / width * cos(_angle)), float_t(1.f / height * sin(_angle)));
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		params.image.set_texture(_input_texture);
+		params.image_texel.set_float2(float_t(1. / width * cos(_angle)), float_t(1.f / height * sin(_angle)));
+		params.step_scale.set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		params.size.set_float(float_t(_size));
+		params.size_inverse_mul.set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
 
 		{
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -443,14 +455,15 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_rotationa
 
 	// One Pass Blur
 	streamfx::obs::gs::effect effect = _data->get_effect();
+	auto&                     params = _data->get_parameters();
 	if (effect) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
-		effect.get_parameter("pAngle").set_float(float_t(_angle / _size));
-		effect.get_parameter("pCenter").set_float2(float_t(_center.first), float_t(_center.second));
+		params.image.set_texture(_input_texture);
+		params.image_texel.set_float2(float_t(1.f / width), float_t(1.f / height));
+		params.step_scale.set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		params.size.set_float(float_t(_size));
+		params.size_inverse_mul.set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		params.angle.set_float(float_t(_angle / _size));
+		params.center.set_float2(float_t(_center.first), float_t(_center.second));
 
 		{
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -509,13 +522,14 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_zoom::ren
 
 	// One Pass Blur
 	streamfx::obs::gs::effect effect = _data->get_effect();
+	auto&                     params = _data->get_parameters();
 	if (effect) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
-		effect.get_parameter("pCenter").set_float2(float_t(_center.first), float_t(_center.second));
+		params.image.set_texture(_input_texture);
+		params.image_texel.set_float2(float_t(1.f / width), float_t(1.f / height));
+		params.step_scale.set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		params.size.set_float(float_t(_size));
+		params.size_inverse_mul.set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		params.center.set_float2(float_t(_center.first), float_t(_center.second));
 
 		{
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
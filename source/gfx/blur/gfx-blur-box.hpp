@@ -30,8 +30,9 @@
 namespace streamfx::gfx {
 	namespace blur {
 		class box_data {
-			streamfx::obs::gs::effect            _effect;
-			std::shared_ptr<streamfx::gfx::util> _gfx_util;
+			streamfx::obs::gs::effect              _effect;
+			streamfx::gfx::blur::effect_parameters _parameters;
+			std::shared_ptr<streamfx::gfx::util>   _gfx_util;
 
 			public:
 			box_data();
@@ -40,6 +41,8 @@ namespace streamfx::gfx {
 			std::shared_ptr<streamfx::gfx::util> get_gfx_util();
 
 			streamfx::obs::gs::effect get_effect();
+
+			streamfx::gfx::blur::effect_parameters& get_parameters();
 		};
 
 		class box_factory : public ::streamfx::gfx::blur::ifactory {
@@ -95,9 +98,6 @@ namespace streamfx::gfx {
 			std::shared_ptr<::streamfx::obs::gs::texture>      _input_texture;
 			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget;
 
-			private:
-			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget2;
-
 			public:
 			box();
 			virtual ~box() override;
@@ -52,6 +52,7 @@ streamfx::gfx::blur::dual_filtering_data::dual_filtering_data() : _gfx_util(::st
 		auto file = streamfx::data_file_path("effects/blur/dual-filtering.effect");
 		try {
 			_effect = streamfx::obs::gs::effect::create(file);
+			_parameters = ::streamfx::gfx::blur::effect_parameters(_effect);
 		} catch (const std::exception& ex) {
 			DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
 		}
@@ -61,6 +62,7 @@ streamfx::gfx::blur::dual_filtering_data::dual_filtering_data() : _gfx_util(::st
 streamfx::gfx::blur::dual_filtering_data::~dual_filtering_data()
 {
 	auto gctx = streamfx::obs::gs::context();
+	_parameters = ::streamfx::gfx::blur::effect_parameters();
 	_effect.reset();
 }
 
@@ -74,6 +76,11 @@ streamfx::obs::gs::effect streamfx::gfx::blur::dual_filtering_data::get_effect()
 	return _effect;
 }
 
+streamfx::gfx::blur::effect_parameters& streamfx::gfx::blur::dual_filtering_data::get_parameters()
+{
+	return _parameters;
+}
+
 streamfx::gfx::blur::dual_filtering_factory::dual_filtering_factory() {}
 
 streamfx::gfx::blur::dual_filtering_factory::~dual_filtering_factory() {}
@@ -232,7 +239,8 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filterin
 	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Dual-Filtering Blur");
 #endif
 
-	auto effect = _data->get_effect();
+	auto  effect = _data->get_effect();
+	auto& params = _data->get_parameters();
 	if (!effect) {
 		return _input_texture;
 	}
@@ -277,10 +285,9 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filterin
 		}
 
 		// Apply
-		effect.get_parameter("pImage").set_texture(tex);
-		effect.get_parameter("pImageSize").set_float2(static_cast<float>(owidth), static_cast<float>(oheight));
-		effect.get_parameter("pImageTexel")
-			.set_float2(0.5f / static_cast<float>(owidth), 0.5f / static_cast<float>(oheight));
+		params.image.set_texture(tex);
+		params.image_size.set_float2(static_cast<float>(owidth), static_cast<float>(oheight));
+		params.image_texel.set_float2(0.5f / static_cast<float>(owidth), 0.5f / static_cast<float>(oheight));
 
 		{
 			auto op = _rts[n]->render(owidth, oheight);
@@ -307,10 +314,9 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filterin
 		uint32_t oheight = height >> (n - 1);
 
 		// Apply
-		effect.get_parameter("pImage").set_texture(tex);
-		effect.get_parameter("pImageSize").set_float2(static_cast<float>(iwidth), static_cast<float>(iheight));
-		effect.get_parameter("pImageTexel")
-			.set_float2(0.5f / static_cast<float>(iwidth), 0.5f / static_cast<float>(iheight));
+		params.image.set_texture(tex);
+		params.image_size.set_float2(static_cast<float>(iwidth), static_cast<float>(iheight));
+		params.image_texel.set_float2(0.5f / static_cast<float>(iwidth), 0.5f / static_cast<float>(iheight));
 
 		{
 			auto op = _rts[n - 1]->render(owidth, oheight);
@@ -31,8 +31,9 @@
 namespace streamfx::gfx {
 	namespace blur {
 		class dual_filtering_data {
-			streamfx::obs::gs::effect            _effect;
-			std::shared_ptr<streamfx::gfx::util> _gfx_util;
+			streamfx::obs::gs::effect              _effect;
+			streamfx::gfx::blur::effect_parameters _parameters;
+			std::shared_ptr<streamfx::gfx::util>   _gfx_util;
 
 			public:
 			dual_filtering_data();
@@ -41,6 +42,8 @@ namespace streamfx::gfx {
 			std::shared_ptr<streamfx::gfx::util> get_gfx_util();
 
 			streamfx::obs::gs::effect get_effect();
+
+			streamfx::gfx::blur::effect_parameters& get_parameters();
 		};
 
 		class dual_filtering_factory : public ::streamfx::gfx::blur::ifactory {
@@ -18,6 +18,7 @@
 #include "gfx-blur-gaussian-linear.hpp"
 #include "common.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 
 #include "warning-disable.hpp"
 #include <stdexcept>
@@ -43,6 +44,7 @@ streamfx::gfx::blur::gaussian_linear_data::gaussian_linear_data() : _gfx_util(::
 			auto file = streamfx::data_file_path("effects/blur/gaussian-linear.effect");
 			try {
 				_effect = streamfx::obs::gs::effect::create(file);
+				_parameters = ::streamfx::gfx::blur::effect_parameters(_effect);
 			} catch (const std::exception& ex) {
 				DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
 			}
@@ -83,6 +85,7 @@ streamfx::gfx::blur::gaussian_linear_data::gaussian_linear_data() : _gfx_util(::
 
 streamfx::gfx::blur::gaussian_linear_data::~gaussian_linear_data()
 {
+	_parameters = ::streamfx::gfx::blur::effect_parameters();
 	_effect.reset();
 }
 
@@ -91,6 +94,11 @@ streamfx::obs::gs::effect streamfx::gfx::blur::gaussian_linear_data::get_effect(
 	return _effect;
 }
 
+streamfx::gfx::blur::effect_parameters& streamfx::gfx::blur::gaussian_linear_data::get_parameters()
+{
+	return _parameters;
+}
+
 std::vector<float_t> const& streamfx::gfx::blur::gaussian_linear_data::get_kernel(std::size_t width)
 {
 	if (width < 1)
@@ -241,8 +249,7 @@ streamfx::gfx::blur::gaussian_linear::gaussian_linear()
 {
 	auto gctx = streamfx::obs::gs::context();
 
-	_rendertarget  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	_rendertarget = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 streamfx::gfx::blur::gaussian_linear::~gaussian_linear() {}
@@ -303,6 +310,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
 	auto                      kernel = _data->get_kernel(size_t(_size));
+	auto&                     params = _data->get_parameters();
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -311,6 +319,10 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
 
+	// Only the result has to outlive this render, the intermediate pass can use a shared render target.
+	auto temporary =
+		::streamfx::obs::gs::rendertarget_pool::lease(uint32_t(width), uint32_t(height), GS_RGBA, GS_ZS_NONE);
+
 	// Setup
 	gs_set_cull_mode(GS_NEITHER);
 	gs_enable_color(true, true, true, true);
@@ -325,48 +337,48 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_MAX_KERNEL_SIZE);
+	params.image.set_texture(_input_texture);
+	params.step_scale.set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	params.size.set_float(float_t(_size));
+	params.kernel.set_value(kernel.data(), ST_MAX_KERNEL_SIZE);
 
 	// First Pass
 	if (_step_scale.first > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), 0.f);
+		params.image_texel.set_float2(float_t(1.f / width), 0.f);
 
 		{
 #ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = temporary->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				_data->get_gfx_util()->draw_fullscreen_triangle();
 			}
 		}
 
-		std::swap(_rendertarget, _rendertarget2);
-		effect.get_parameter("pImage").set_texture(_rendertarget->get_texture());
+		std::swap(_rendertarget, temporary);
+		params.image.set_texture(_rendertarget->get_texture());
 	}
 
 	// Second Pass
 	if (_step_scale.second > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImageTexel").set_float2(0.f, float_t(1.f / height));
+		params.image_texel.set_float2(0.f, float_t(1.f / height));
 
 		{
 #ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Vertical");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = temporary->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				_data->get_gfx_util()->draw_fullscreen_triangle();
 			}
 		}
 
-		std::swap(_rendertarget, _rendertarget2);
+		std::swap(_rendertarget, temporary);
 	}
 
 	gs_blend_state_pop();
@@ -409,6 +421,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
 	auto                      kernel = _data->get_kernel(size_t(_size));
+	auto&                     params = _data->get_parameters();
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -431,12 +444,11 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel")
-		.set_float2(float_t(1.f / width * cos(_angle)), float_t(1.f / height * sin(_angle)));
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_MAX_KERNEL_SIZE);
+	params.image.set_texture(_input_texture);
+	params.image_texel.set_float2(float_t(1.f / width * cos(_angle)), float_t(1.f / height * sin(_angle)));
+	params.step_scale.set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	params.size.set_float(float_t(_size));
+	params.kernel.set_value(kernel.data(), ST_MAX_KERNEL_SIZE);
 
 	// First Pass
 	{
@@ -31,9 +31,10 @@
 namespace streamfx::gfx {
 	namespace blur {
 		class gaussian_linear_data {
-			streamfx::obs::gs::effect            _effect;
-			std::shared_ptr<streamfx::gfx::util> _gfx_util;
-			std::vector<std::vector<float_t>>    _kernels;
+			streamfx::obs::gs::effect              _effect;
+			streamfx::gfx::blur::effect_parameters _parameters;
+			std::shared_ptr<streamfx::gfx::util>   _gfx_util;
+			std::vector<std::vector<float_t>>      _kernels;
 
 			public:
 			gaussian_linear_data();
@@ -43,6 +44,8 @@ namespace streamfx::gfx {
 
 			streamfx::obs::gs::effect get_effect();
 
+			streamfx::gfx::blur::effect_parameters& get_parameters();
+
 			std::vector<float_t> const& get_kernel(std::size_t width);
 		};
 
@@ -99,9 +102,6 @@ namespace streamfx::gfx {
 			std::shared_ptr<::streamfx::obs::gs::texture>      _input_texture;
 			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget;
 
-			private:
-			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget2;
-
 			public:
 			gaussian_linear();
 			virtual ~gaussian_linear() override;
@@ -19,6 +19,7 @@
 #include "common.hpp"
 #include "gfx/gfx-util.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "plugin.hpp"
 
 #include "warning-disable.hpp"
@@ -46,6 +47,7 @@ streamfx::gfx::blur::gaussian_data::gaussian_data() : _gfx_util(::streamfx::gfx:
 			auto file = streamfx::data_file_path("effects/blur/gaussian.effect");
 			try {
 				_effect = streamfx::obs::gs::effect::create(file);
+				_parameters = ::streamfx::gfx::blur::effect_parameters(_effect);
 			} catch (const std::exception& ex) {
 				DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
 			}
@@ -107,6 +109,7 @@ streamfx::gfx::blur::gaussian_data::gaussian_data() : _gfx_util(::streamfx::gfx:
 streamfx::gfx::blur::gaussian_data::~gaussian_data()
 {
 	auto gctx = streamfx::obs::gs::context();
+	_parameters = ::streamfx::gfx::blur::effect_parameters();
 	_effect.reset();
 }
 
@@ -115,6 +118,11 @@ streamfx::obs::gs::effect streamfx::gfx::blur::gaussian_data::get_effect()
 	return _effect;
 }
 
+streamfx::gfx::blur::effect_parameters& streamfx::gfx::blur::gaussian_data::get_parameters()
+{
+	return _parameters;
+}
+
 std::shared_ptr<streamfx::gfx::util> streamfx::gfx::blur::gaussian_data::get_gfx_util()
 {
 	return _gfx_util;
@@ -268,9 +276,8 @@ std::shared_ptr<::streamfx::gfx::blur::gaussian_data> streamfx::gfx::blur::gauss
 streamfx::gfx::blur::gaussian::gaussian()
 	: _data(::streamfx::gfx::blur::gaussian_factory::get().data()), _size(1.), _step_scale({1., 1.})
 {
-	auto gctx      = streamfx::obs::gs::context();
-	_rendertarget  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	auto gctx     = streamfx::obs::gs::context();
+	_rendertarget = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 streamfx::gfx::blur::gaussian::~gaussian() {}
@@ -330,6 +337,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian::ren
 #endif
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
+	auto&                     params = _data->get_parameters();
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -339,6 +347,10 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian::ren
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
 
+	// Only the result has to outlive this render, the intermediate pass can use a shared render target.
+	auto temporary =
+		::streamfx::obs::gs::rendertarget_pool::lease(uint32_t(width), uint32_t(height), GS_RGBA, GS_ZS_NONE);
+
 	// Setup
 	gs_set_cull_mode(GS_NEITHER);
 	gs_enable_color(true, true, true, true);
@@ -353,48 +365,48 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian::ren
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	params.step_scale.set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	params.size.set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
+	params.kernel.set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	// First Pass
 	if (_step_scale.first > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), 0.f);
+		params.image.set_texture(_input_texture);
+		params.image_texel.set_float2(float_t(1.f / width), 0.f);
 
 		{
 #ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = temporary->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				_data->get_gfx_util()->draw_fullscreen_triangle();
 			}
 		}
 
-		std::swap(_rendertarget, _rendertarget2);
+		std::swap(_rendertarget, temporary);
 	}
 
 	// Second Pass
 	if (_step_scale.second > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImage").set_texture(_rendertarget->get_texture());
-		effect.get_parameter("pImageTexel").set_float2(0.f, float_t(1.f / height));
+		params.image.set_texture(_rendertarget->get_texture());
+		params.image_texel.set_float2(0.f, float_t(1.f / height));
 
 		{
 #ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Vertical");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = temporary->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				_data->get_gfx_util()->draw_fullscreen_triangle();
 			}
 		}
 
-		std::swap(_rendertarget, _rendertarget2);
+		std::swap(_rendertarget, temporary);
 	}
 
 	gs_blend_state_pop();
@@ -436,6 +448,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_dire
 #endif
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
+	auto&                     params = _data->get_parameters();
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -459,12 +472,11 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_dire
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel")
-		.set_float2(float_t(1.f / width * cos(m_angle)), float_t(1.f / height * sin(m_angle)));
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	params.image.set_texture(_input_texture);
+	params.image_texel.set_float2(float_t(1.f / width * cos(m_angle)), float_t(1.f / height * sin(m_angle)));
+	params.step_scale.set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	params.size.set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
+	params.kernel.set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	{
 		auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -494,6 +506,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_rota
 #endif
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
+	auto&                     params = _data->get_parameters();
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -517,13 +530,13 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_rota
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pAngle").set_float(float_t(m_angle / _size));
-	effect.get_parameter("pCenter").set_float2(float_t(m_center.first), float_t(m_center.second));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	params.image.set_texture(_input_texture);
+	params.image_texel.set_float2(float_t(1.f / width), float_t(1.f / height));
+	params.step_scale.set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	params.size.set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
+	params.angle.set_float(float_t(m_angle / _size));
+	params.center.set_float2(float_t(m_center.first), float_t(m_center.second));
+	params.kernel.set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	// First Pass
 	{
@@ -576,6 +589,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_zoom
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
 	auto                      kernel = _data->get_kernel(size_t(_size));
+	auto&                     params = _data->get_parameters();
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -598,12 +612,12 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_zoom
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size));
-	effect.get_parameter("pCenter").set_float2(float_t(m_center.first), float_t(m_center.second));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	params.image.set_texture(_input_texture);
+	params.image_texel.set_float2(float_t(1.f / width), float_t(1.f / height));
+	params.step_scale.set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	params.size.set_float(float_t(_size));
+	params.center.set_float2(float_t(m_center.first), float_t(m_center.second));
+	params.kernel.set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	// First Pass
 	{
@@ -31,9 +31,10 @@
 namespace streamfx::gfx {
 	namespace blur {
 		class gaussian_data {
-			streamfx::obs::gs::effect            _effect;
-			std::shared_ptr<streamfx::gfx::util> _gfx_util;
-			std::map<size_t, std::vector<float>> _kernels;
+			streamfx::obs::gs::effect              _effect;
+			streamfx::gfx::blur::effect_parameters _parameters;
+			std::shared_ptr<streamfx::gfx::util>   _gfx_util;
+			std::map<size_t, std::vector<float>>   _kernels;
 
 			public:
 			gaussian_data();
@@ -41,6 +42,8 @@ namespace streamfx::gfx {
 
 			streamfx::obs::gs::effect get_effect();
 
+			streamfx::gfx::blur::effect_parameters& get_parameters();
+
 			std::shared_ptr<streamfx::gfx::util> get_gfx_util();
 
 			std::vector<float_t> const& get_kernel(std::size_t width);
@@ -99,9 +102,6 @@ namespace streamfx::gfx {
 			std::shared_ptr<::streamfx::obs::gs::texture>      _input_texture;
 			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget;
 
-			private:
-			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget2;
-
 			public:
 			gaussian();
 			virtual ~gaussian() override;
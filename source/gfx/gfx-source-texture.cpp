@@ -17,6 +17,7 @@
 
 #include "gfx-source-texture.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/obs-source-graph.hpp"
 #include "obs/obs-tools.hpp"
 
 #include "warning-disable.hpp"
@@ -27,6 +28,9 @@ streamfx::gfx::source_texture::~source_texture()
 {
 	if (_child && _parent) {
 		obs_source_remove_active_child(_parent.get(), _child.get());
+		if (auto graph = ::streamfx::obs::source_graph::instance(); graph) {
+			graph->invalidate(_parent.get());
+		}
 	}
 }
 
@@ -44,6 +48,9 @@ streamfx::gfx::source_texture::source_texture(streamfx::obs::source child, strea
 	} else if (!obs_source_add_active_child(parent, child)) {
 		throw std::runtime_error("Child contains Parent");
 	}
+	if (auto graph = ::streamfx::obs::source_graph::instance(); graph) {
+		graph->invalidate(parent);
+	}
 
 	_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
@@ -65,6 +72,9 @@ void streamfx::gfx::source_texture::clear()
 {
 	if (_child && _parent) {
 		obs_source_remove_active_child(_parent.get(), _child.get());
+		if (auto graph = ::streamfx::obs::source_graph::instance(); graph) {
+			graph->invalidate(_parent.get());
+		}
 	}
 	_child = {};
 }
@@ -214,22 +214,18 @@ void streamfx::gfx::shader::texture_parameter::properties(obs_properties_t* prop
 			auto p = obs_properties_add_list(pr, _keys[2].c_str(), D_TRANSLATE(ST_I18N_SOURCE), OBS_COMBO_TYPE_LIST,
 											 OBS_COMBO_FORMAT_STRING);
 			obs_property_list_add_string(p, "", "");
-			obs::source_tracker::get()->enumerate(
-				[&p](std::string name, obs_source_t*) {
-					std::stringstream sstr;
-					sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SOURCE) << ")";
-					obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
-					return false;
-				},
-				obs::source_tracker::filter_video_sources);
-			obs::source_tracker::get()->enumerate(
-				[&p](std::string name, obs_source_t*) {
-					std::stringstream sstr;
-					sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SCENE) << ")";
-					obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
-					return false;
-				},
-				obs::source_tracker::filter_scenes);
+			auto video_sources = obs::source_tracker::get()->names(obs::source_tracker::category::VIDEO);
+			for (auto& name : *video_sources) {
+				std::stringstream sstr;
+				sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SOURCE) << ")";
+				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
+			}
+			auto scenes = obs::source_tracker::get()->names(obs::source_tracker::category::SCENE);
+			for (auto& name : *scenes) {
+				std::stringstream sstr;
+				sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SCENE) << ")";
+				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
+			}
 		}
 
 		modified_type(this, props, nullptr, settings);
@@ -275,7 +271,7 @@ void streamfx::gfx::shader::texture_parameter::update(obs_data_t* settings)
 	}
 }
 
-void streamfx::gfx::shader::texture_parameter::assign()
+void streamfx::gfx::shader::texture_parameter::capture()
 {
 	if (is_automatic())
 		return;
@@ -366,6 +362,12 @@ void streamfx::gfx::shader::texture_parameter::assign()
 		gs_blend_state_pop();
 		gs_matrix_pop();
 	}
+}
+
+void streamfx::gfx::shader::texture_parameter::assign()
+{
+	if (is_automatic())
+		return;
 
 	if (_type == texture_type::Source) {
 		if (_source_rendertarget) {
@@ -81,6 +81,8 @@ namespace streamfx::gfx {
 
 			void update(obs_data_t* settings) override;
 
+			void capture() override;
+
 			void assign() override;
 
 			void visible(bool visible) override;
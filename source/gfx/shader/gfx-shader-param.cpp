@@ -180,6 +180,8 @@ void streamfx::gfx::shader::parameter::properties(obs_properties_t* props, obs_d
 
 void streamfx::gfx::shader::parameter::update(obs_data_t* settings) {}
 
+void streamfx::gfx::shader::parameter::capture() {}
+
 void streamfx::gfx::shader::parameter::assign() {}
 
 void streamfx::gfx::shader::parameter::visible(bool visible) {}
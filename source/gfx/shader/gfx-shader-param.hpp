@@ -87,6 +87,9 @@ namespace streamfx::gfx {
 
 			virtual void update(obs_data_t* settings);
 
+			/** Render anything the value depends on. Called for every parameter before any of them is assigned. */
+			virtual void capture();
+
 			virtual void assign();
 
 			virtual void visible(bool visible);
@@ -49,12 +49,16 @@
 streamfx::gfx::shader::shader::shader(obs_source_t* self, shader_mode mode)
 	: _self(self), _gfx_util(::streamfx::gfx::util::get()), _mode(mode), _base_width(1), _base_height(1), _active(true),
 
-	  _shader(), _shader_file(), _shader_tech("Draw"), _shader_file_mt(), _shader_file_sz(), _shader_file_tick(0),
+	  _shader(), _shader_file(), _shader_tech("Draw"), _shader_tech_requested("Draw"), _shader_file_mt(),
+	  _shader_file_sz(), _shader_file_tick(0), _shader_params(), _shader_compile(),
 
 	  _width_type(size_type::Percent), _width_value(1.0), _height_type(size_type::Percent), _height_value(1.0),
 
 	  _have_current_params(false), _time(0), _time_loop(0), _loops(0), _random(), _random_seed(0),
 
+	  _input_a(), _input_a_srgb(false), _input_b(), _input_b_srgb(false), _transition_time(0), _transition_width(0),
+	  _transition_height(0),
+
 	  _rt_up_to_date(false), _rt(std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA_UNORM, GS_ZS_NONE))
 {
 	// Initialize random values.
@@ -109,18 +113,19 @@ bool streamfx::gfx::shader::shader::load_shader(const std::filesystem::path& fil
 		if (!std::filesystem::exists(file))
 			return false;
 
-		shader_dirty = is_shader_different(file);
-		param_dirty  = is_technique_different(tech) || shader_dirty;
+		// Shaders finish compiling later, so the technique has to be remembered until then.
+		if (tech != _shader_tech_requested) {
+			_shader_tech_requested = tech;
+		}
 
-		// Update Shader
-		if (shader_dirty) {
-			_shader           = streamfx::obs::gs::effect(file);
-			_shader_file_mt   = std::filesystem::last_write_time(file);
-			_shader_file_sz   = std::filesystem::file_size(file);
-			_shader_file      = file;
-			_shader_file_tick = 0;
+		// Compile changed shaders in the background, the current one is kept until the new one is ready.
+		if (is_shader_different(file)) {
+			compile_shader(file);
 		}
 
+		shader_dirty = apply_compiled_shader();
+		param_dirty  = (is_technique_different(tech) || shader_dirty) && _shader;
+
 		// Update Params
 		if (param_dirty) {
 			auto settings =
@@ -136,7 +141,8 @@ bool streamfx::gfx::shader::shader::load_shader(const std::filesystem::path& fil
 			if (have_valid_tech) {
 				_shader_tech = tech;
 			} else {
-				_shader_tech = _shader.get_technique(0).name();
+				_shader_tech           = _shader.get_technique(0).name();
+				_shader_tech_requested = _shader_tech;
 
 				// Update source data.
 				obs_data_set_string(settings.get(), ST_KEY_SHADER_TECHNIQUE, _shader_tech.c_str());
@@ -185,6 +191,71 @@ bool streamfx::gfx::shader::shader::load_shader(const std::filesystem::path& fil
 	}
 }
 
+void streamfx::gfx::shader::shader::compile_shader(const std::filesystem::path& file)
+{
+	// Remember the file right away, so that it is not queued again while it is still being compiled.
+	_shader_file_mt   = std::filesystem::last_write_time(file);
+	_shader_file_sz   = std::filesystem::file_size(file);
+	_shader_file      = file;
+	_shader_file_tick = 0;
+
+	// Any job still running for a previous file is orphaned, and its result is discarded once it finishes.
+	auto job  = std::make_shared<compile_job>();
+	job->file = file;
+	job->finished.store(false);
+	_shader_compile = job;
+
+	// Neither step may throw, as a failed load would cancel the compilation, which is what finishes the job.
+	auto load = [job](streamfx::util::threadpool::task_data_t) {
+		try {
+			job->code   = streamfx::obs::gs::effect::load_shared(job->file);
+			job->effect = streamfx::obs::gs::effect::find_shared(job->code);
+		} catch (const std::exception& ex) {
+			job->error = ex.what();
+		} catch (...) {
+			job->error = "Unknown error.";
+		}
+	};
+	auto compile = [job](streamfx::util::threadpool::task_data_t) {
+		try {
+			if (!job->effect && job->error.empty()) {
+				job->effect = streamfx::obs::gs::effect::create_shared(job->code);
+			}
+		} catch (const std::exception& ex) {
+			job->error = ex.what();
+		} catch (...) {
+			job->error = "Unknown error.";
+		}
+		job->finished.store(true, std::memory_order_release);
+	};
+	if (auto threadpool = streamfx::threadpool(); threadpool) {
+		// Reading files may be delayed arbitrarily, but the compilation holds the graphics context that the render
+		// thread waits for, so it must run at a priority the scheduler does not starve.
+		auto task = threadpool->push(load, nullptr, streamfx::util::threadpool::priority::BACKGROUND);
+		threadpool->then(task, compile, nullptr, streamfx::util::threadpool::priority::NORMAL);
+	} else {
+		load(nullptr);
+		compile(nullptr);
+	}
+}
+
+bool streamfx::gfx::shader::shader::apply_compiled_shader()
+{
+	if (!_shader_compile || !_shader_compile->finished.load(std::memory_order_acquire)) {
+		return false;
+	}
+
+	auto job = std::move(_shader_compile);
+	if (!job->effect) {
+		// Keep rendering with the previous shader, if there is one.
+		DLOG_ERROR("Loading shader '%s' failed with error: %s", job->file.u8string().c_str(), job->error.c_str());
+		return false;
+	}
+
+	_shader = std::move(job->effect);
+	return true;
+}
+
 void streamfx::gfx::shader::shader::defaults(obs_data_t* data)
 {
 	obs_data_set_default_string(data, ST_KEY_SHADER_FILE, "");
@@ -427,11 +498,19 @@ uint32_t streamfx::gfx::shader::shader::base_height()
 
 bool streamfx::gfx::shader::shader::tick(float_t time)
 {
+	// Check the file for changes every few frames, but swap in a freshly compiled shader as soon as it is ready.
+	bool shader_dirty = false;
 	_shader_file_tick = static_cast<float_t>(static_cast<double_t>(_shader_file_tick) + static_cast<double_t>(time));
-	if (_shader_file_tick >= 1.0f / 3.0f) {
-		_shader_file_tick -= 1.0f / 3.0f;
-		bool v1, v2;
-		load_shader(_shader_file, _shader_tech, v1, v2);
+	if ((_shader_file_tick >= 1.0f / 3.0f) || (_shader_compile && _shader_compile->finished.load())) {
+		if (_shader_file_tick >= 1.0f / 3.0f) {
+			_shader_file_tick -= 1.0f / 3.0f;
+		}
+		bool param_dirty;
+		load_shader(_shader_file, _shader_tech_requested, shader_dirty, param_dirty);
+		if (shader_dirty) {
+			// The properties were built for the previous shader.
+			obs_source_update_properties(_self);
+		}
 	}
 
 	// Update State
@@ -455,7 +534,8 @@ bool streamfx::gfx::shader::shader::tick(float_t time)
 	// Flag Render Target as outdated.
 	_rt_up_to_date = false;
 
-	return false;
+	// Have the owner apply its settings to the parameters of the new shader.
+	return shader_dirty;
 }
 
 void streamfx::gfx::shader::shader::prepare_render()
@@ -463,11 +543,62 @@ void streamfx::gfx::shader::shader::prepare_render()
 	if (!_shader)
 		return;
 
+	for (auto kv : _shader_params) {
+		kv.second->capture();
+	}
+}
+
+void streamfx::gfx::shader::shader::assign_parameters()
+{
 	// Assign user parameters
 	for (auto kv : _shader_params) {
 		kv.second->assign();
 	}
 
+	// Assign inputs
+	{
+		std::string_view params[] = {
+			"InputA",
+			"image",
+			"tex_a",
+		};
+		for (auto& name : params) {
+			if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter(name.data()); el != nullptr) {
+				if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Texture) {
+					el.set_texture(_input_a, _input_a_srgb);
+					break;
+				}
+			}
+		}
+	}
+	{
+		std::string_view params[] = {
+			"InputB",
+			"image2",
+			"tex_b",
+		};
+		for (auto& name : params) {
+			if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter(name.data()); el != nullptr) {
+				if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Texture) {
+					el.set_texture(_input_b, _input_b_srgb);
+					break;
+				}
+			}
+		}
+	}
+
+	if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter("TransitionTime"); el != nullptr) {
+		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Float) {
+			el.set_float(_transition_time);
+		}
+	}
+
+	if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter("TransitionSize"); el != nullptr) {
+		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Integer2) {
+			el.set_int2(static_cast<int32_t>(_transition_width), static_cast<int32_t>(_transition_height));
+		}
+	}
+
 	// float4 Time: (Time in Seconds), (Time in Current Second), (Time in Seconds only), (Random Value)
 	if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter("Time"); el != nullptr) {
 		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Float4) {
@@ -498,8 +629,6 @@ void streamfx::gfx::shader::shader::prepare_render()
 			el.set_int(_random_seed);
 		}
 	}
-
-	return;
 }
 
 void streamfx::gfx::shader::shader::render(gs_effect* effect)
@@ -533,10 +662,16 @@ void streamfx::gfx::shader::shader::render(gs_effect* effect)
 		bool old_srgb = gs_framebuffer_srgb_enabled();
 		gs_enable_framebuffer_srgb(false);
 
+		// Other instances may have changed the values of the shared effect since prepare_render().
+		assign_parameters();
 		while (gs_effect_loop(_shader.get_object(), _shader_tech.c_str())) {
 			_gfx_util->draw_fullscreen_triangle();
 		}
 
+		// The inputs may only wrap textures owned by libOBS, which aren't guaranteed to outlive this frame.
+		_input_a.reset();
+		_input_b.reset();
+
 		// Restore sRGB Status
 		gs_enable_framebuffer_srgb(old_srgb);
 
@@ -566,65 +701,25 @@ void streamfx::gfx::shader::shader::set_size(uint32_t w, uint32_t h)
 
 void streamfx::gfx::shader::shader::set_input_a(std::shared_ptr<streamfx::obs::gs::texture> tex, bool srgb)
 {
-	if (!_shader)
-		return;
-
-	std::string_view params[] = {
-		"InputA",
-		"image",
-		"tex_a",
-	};
-	for (auto& name : params) {
-		if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter(name.data()); el != nullptr) {
-			if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Texture) {
-				el.set_texture(tex, srgb);
-				break;
-			}
-		}
-	}
+	_input_a      = tex;
+	_input_a_srgb = srgb;
 }
 
 void streamfx::gfx::shader::shader::set_input_b(std::shared_ptr<streamfx::obs::gs::texture> tex, bool srgb)
 {
-	if (!_shader)
-		return;
-
-	std::string_view params[] = {
-		"InputB",
-		"image2",
-		"tex_b",
-	};
-	for (auto& name : params) {
-		if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter(name.data()); el != nullptr) {
-			if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Texture) {
-				el.set_texture(tex, srgb);
-				break;
-			}
-		}
-	}
+	_input_b      = tex;
+	_input_b_srgb = srgb;
 }
 
 void streamfx::gfx::shader::shader::set_transition_time(float_t t)
 {
-	if (!_shader)
-		return;
-
-	if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter("TransitionTime"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Float) {
-			el.set_float(t);
-		}
-	}
+	_transition_time = t;
 }
 
 void streamfx::gfx::shader::shader::set_transition_size(uint32_t w, uint32_t h)
 {
-	if (!_shader)
-		return;
-	if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter("TransitionSize"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Integer2) {
-			el.set_int2(static_cast<int32_t>(w), static_cast<int32_t>(h));
-		}
-	}
+	_transition_width  = w;
+	_transition_height = h;
 }
 
 void streamfx::gfx::shader::shader::set_visible(bool visible)
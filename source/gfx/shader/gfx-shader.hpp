@@ -23,6 +23,7 @@
 #include "obs/gs/gs-rendertarget.hpp"
 
 #include "warning-disable.hpp"
+#include <atomic>
 #include <filesystem>
 #include <list>
 #include <map>
@@ -60,11 +61,22 @@ namespace streamfx::gfx {
 			streamfx::obs::gs::effect       _shader;
 			std::filesystem::path           _shader_file;
 			std::string                     _shader_tech;
+			std::string                     _shader_tech_requested;
 			std::filesystem::file_time_type _shader_file_mt;
 			uintmax_t                       _shader_file_sz;
 			float_t                         _shader_file_tick;
 			shader_param_map_t              _shader_params;
 
+			// Background Compilation
+			struct compile_job {
+				std::filesystem::path                  file;
+				std::atomic<bool>                      finished;
+				streamfx::obs::gs::effect::shared_code code;
+				streamfx::obs::gs::effect              effect;
+				std::string                            error;
+			};
+			std::shared_ptr<compile_job> _shader_compile;
+
 			// Options
 			size_type _width_type;
 			double_t  _width_value;
@@ -80,6 +92,15 @@ namespace streamfx::gfx {
 			int32_t         _random_seed;
 			float_t _random_values[16]; // 0..4 Per-Instance-Random, 4..8 Per-Activation-Random 9..15 Per-Frame-Random
 
+			// Values from the owner, only assigned right before drawing.
+			std::shared_ptr<streamfx::obs::gs::texture> _input_a;
+			bool                                        _input_a_srgb;
+			std::shared_ptr<streamfx::obs::gs::texture> _input_b;
+			bool                                        _input_b_srgb;
+			float_t                                     _transition_time;
+			uint32_t                                    _transition_width;
+			uint32_t                                    _transition_height;
+
 			// Rendering
 			bool                                             _rt_up_to_date;
 			std::shared_ptr<streamfx::obs::gs::rendertarget> _rt;
@@ -95,6 +116,10 @@ namespace streamfx::gfx {
 			bool load_shader(const std::filesystem::path& file, std::string_view tech, bool& shader_dirty,
 							 bool& param_dirty);
 
+			void compile_shader(const std::filesystem::path& file);
+
+			bool apply_compiled_shader();
+
 			static void defaults(obs_data_t* data);
 
 			void properties(obs_properties_t* props);
@@ -117,6 +142,12 @@ namespace streamfx::gfx {
 
 			bool tick(float_t time);
 
+			/** Capture everything the parameters depend on, like other sources.
+			 *
+			 * Effects are shared between instances that use the same file, and capturing a source may render another
+			 * instance with the same effect. Parameter values are therefore only assigned by render(), right before
+			 * drawing.
+			 */
 			void prepare_render();
 
 			void render(gs_effect* effect);
@@ -139,6 +170,9 @@ namespace streamfx::gfx {
 			void set_visible(bool visible);
 
 			void set_active(bool active);
+
+			private:
+			void assign_parameters();
 		};
 	} // namespace shader
 } // namespace streamfx::gfx
@@ -23,8 +23,11 @@
 
 #include "warning-disable.hpp"
 #include <fstream>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <tuple>
 #include <vector>
 #include "warning-enable.hpp"
 
@@ -48,10 +51,13 @@ static std::string load_file_as_code(const std::filesystem::path& shader_file, b
 		throw std::runtime_error("Failed to open file.");
 	}
 
-	// Push Graphics API to shader.
-	if (is_top_level) {
+	// Push Graphics API to shader. The device never changes while libOBS runs, so only enter the graphics context once.
+	static const int device_type = []() {
 		auto gctx = streamfx::obs::gs::context();
-		switch (gs_get_device_type()) {
+		return gs_get_device_type();
+	}();
+	if (is_top_level) {
+		switch (device_type) {
 		case GS_DEVICE_DIRECT3D_11:
 			shader_stream << "#define GS_DEVICE_DIRECT3D_11" << std::endl;
 			shader_stream << "#define GS_DEVICE_DIRECT3D" << std::endl;
@@ -112,6 +118,13 @@ streamfx::obs::gs::effect::effect(std::string_view code, std::string_view name)
 	}
 
 	reset(effect, [](gs_effect_t* ptr) { gs_effect_destroy(ptr); });
+
+	// Index all parameters by the hash of their name, they never change after compilation.
+	_parameter_index = std::make_shared<std::unordered_multimap<std::size_t, std::size_t>>();
+	_parameter_index->reserve(count_parameters());
+	for (std::size_t idx = 0; idx < count_parameters(); idx++) {
+		_parameter_index->emplace(std::hash<std::string_view>{}(std::string_view(get()->params.array[idx].name)), idx);
+	}
 }
 
 streamfx::obs::gs::effect::effect(std::filesystem::path file)
@@ -119,6 +132,85 @@ streamfx::obs::gs::effect::effect(std::filesystem::path file)
 			 streamfx::util::platform::utf8_to_native(std::filesystem::absolute(file)).generic_u8string())
 {}
 
+// Effects are identified by where they were loaded from and what was actually compiled, so that includes and changes
+// on disk produce a new effect instead of returning an outdated one.
+typedef std::tuple<std::string, std::size_t, std::size_t> shared_key_t;
+struct shared_entry_t {
+	std::weak_ptr<gs_effect_t>                                         effect;
+	std::shared_ptr<std::unordered_multimap<std::size_t, std::size_t>> parameter_index;
+};
+static std::mutex                              _shared_lock;
+static std::map<shared_key_t, shared_entry_t> _shared_cache;
+
+static shared_key_t make_shared_key(const streamfx::obs::gs::effect::shared_code& code)
+{
+	return {code.path, code.code.size(), std::hash<std::string>{}(code.code)};
+}
+
+streamfx::obs::gs::effect streamfx::obs::gs::effect::create_shared(const std::filesystem::path& file)
+{
+	return create_shared(load_shared(file));
+}
+
+streamfx::obs::gs::effect::shared_code streamfx::obs::gs::effect::load_shared(const std::filesystem::path& file)
+{
+	shared_code result;
+	result.code = load_file_as_code(file);
+	result.name = streamfx::util::platform::utf8_to_native(std::filesystem::absolute(file)).generic_u8string();
+	result.path = std::filesystem::weakly_canonical(file).generic_u8string();
+	return result;
+}
+
+streamfx::obs::gs::effect streamfx::obs::gs::effect::find_shared(const shared_code& code)
+{
+	auto key = make_shared_key(code);
+
+	std::lock_guard<std::mutex> lock(_shared_lock);
+
+	// Evict everything that is no longer in use, there are only ever a few dozen entries.
+	for (auto kv = _shared_cache.begin(); kv != _shared_cache.end();) {
+		if (kv->second.effect.expired()) {
+			kv = _shared_cache.erase(kv);
+		} else {
+			kv++;
+		}
+	}
+
+	streamfx::obs::gs::effect result;
+	if (auto kv = _shared_cache.find(key); kv != _shared_cache.end()) {
+		if (auto ptr = kv->second.effect.lock(); ptr) {
+			static_cast<std::shared_ptr<gs_effect_t>&>(result) = std::move(ptr);
+			result._parameter_index                           = kv->second.parameter_index;
+		}
+	}
+	return result;
+}
+
+streamfx::obs::gs::effect streamfx::obs::gs::effect::create_shared(const shared_code& code)
+{
+	if (auto result = find_shared(code); result) {
+		return result;
+	}
+
+	// Compile without holding the lock, as this enters the graphics context which may be held by a waiting thread.
+	streamfx::obs::gs::effect compiled{code.code, code.name};
+	{
+		std::lock_guard<std::mutex> lock(_shared_lock);
+		auto                        key = make_shared_key(code);
+		if (auto kv = _shared_cache.find(key); kv != _shared_cache.end()) {
+			if (auto ptr = kv->second.effect.lock(); ptr) {
+				// Someone else was faster, discard ours once the lock is released.
+				streamfx::obs::gs::effect result;
+				static_cast<std::shared_ptr<gs_effect_t>&>(result) = std::move(ptr);
+				result._parameter_index                           = kv->second.parameter_index;
+				return result;
+			}
+		}
+		_shared_cache.insert_or_assign(key, shared_entry_t{compiled, compiled._parameter_index});
+	}
+	return compiled;
+}
+
 streamfx::obs::gs::effect::~effect()
 {
 	auto gctx = streamfx::obs::gs::context();
@@ -174,6 +266,17 @@ streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(std
 
 streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(std::string_view name)
 {
+	if (_parameter_index) {
+		auto range = _parameter_index->equal_range(std::hash<std::string_view>{}(name));
+		for (auto kv = range.first; kv != range.second; kv++) {
+			auto ptr = get()->params.array + kv->second;
+			if (name == ptr->name) {
+				return streamfx::obs::gs::effect_parameter(ptr, *this);
+			}
+		}
+		return nullptr;
+	}
+
 	for (std::size_t idx = 0; idx < count_parameters(); idx++) {
 		auto ptr = get()->params.array + idx;
 		if (strcmp(ptr->name, name.data()) == 0) {
@@ -25,16 +25,52 @@
 #include "warning-disable.hpp"
 #include <filesystem>
 #include <list>
+#include <unordered_map>
 #include "warning-enable.hpp"
 
 namespace streamfx::obs::gs {
 	class effect : public std::shared_ptr<gs_effect_t> {
+		/** Parameter indices by hash of their name, to avoid comparing every name on lookup.
+		 *
+		 * Render code that sets the same parameters every frame should resolve them once with get_parameter() and keep
+		 * the returned effect_parameter around instead.
+		 */
+		std::shared_ptr<std::unordered_multimap<std::size_t, std::size_t>> _parameter_index;
+
 		public:
 		effect() = default;
 		effect(std::string_view code, std::string_view name);
 		effect(std::filesystem::path file);
 		~effect();
 
+		/** Load an effect from a file, or reuse the already compiled effect if the file was loaded before.
+		 *
+		 * The compiled effect is shared by everyone who loaded the same file with the same content, and is kept alive only
+		 * as long as someone uses it. Parameter values are shared as well, so users must set every parameter they rely on
+		 * before rendering with it.
+		 */
+		static streamfx::obs::gs::effect create_shared(const std::filesystem::path& file);
+
+		/** Preprocessed code of an effect file, and what identifies it in the shared cache.
+		 *
+		 * Loading, looking up and compiling are separate steps, so that callers can read and preprocess files at a low
+		 * priority, but enter the graphics context for the compilation at a regular one.
+		 */
+		struct shared_code {
+			std::string code;
+			std::string name;
+			std::string path;
+		};
+
+		/** Read and preprocess an effect file for the shared cache. */
+		static shared_code load_shared(const std::filesystem::path& file);
+
+		/** Retrieve an already compiled effect for the code, or an empty effect. Does not enter the graphics context. */
+		static streamfx::obs::gs::effect find_shared(const shared_code& code);
+
+		/** Retrieve an already compiled effect for the code, or compile it in the graphics context. */
+		static streamfx::obs::gs::effect create_shared(const shared_code& code);
+
 		std::size_t                         count_techniques();
 		streamfx::obs::gs::effect_technique get_technique(std::size_t idx);
 		streamfx::obs::gs::effect_technique get_technique(std::string_view name);
@@ -21,6 +21,10 @@
 #include "common.hpp"
 #include "plugin.hpp"
 
+#ifdef ENABLE_PROFILING
+#include "util/util-trace.hpp"
+#endif
+
 #include "warning-disable.hpp"
 #include <vector>
 #include "warning-enable.hpp"
@@ -67,7 +71,8 @@ namespace streamfx::obs::gs {
 	static const float_t* debug_color_render       = debug_color_teal;
 
 	class debug_marker {
-		std::string _name;
+		std::string                                    _name;
+		std::chrono::high_resolution_clock::time_point _start;
 
 		public:
 		inline debug_marker(const float_t color[4], const char* format, ...)
@@ -80,13 +85,15 @@ namespace streamfx::obs::gs {
 			size = static_cast<size_t>(vsnprintf(buffer.data(), buffer.size(), format, vargs));
 			va_end(vargs);
 
-			_name = std::string(buffer.data(), buffer.data() + size);
+			_name = std::string(buffer.data(), buffer.data() + std::min(size, buffer.size() - 1));
 			gs_debug_marker_begin(color, _name.c_str());
+			_start = std::chrono::high_resolution_clock::now();
 		}
 
 		inline ~debug_marker()
 		{
 			gs_debug_marker_end();
+			::streamfx::util::trace::record(_name.c_str(), _start, std::chrono::high_resolution_clock::now());
 		}
 	};
 #endif
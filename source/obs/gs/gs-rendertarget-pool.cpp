@@ -0,0 +1,215 @@
+// Copyright (c) 2022 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gs-rendertarget-pool.hpp"
+#include "statistics.hpp"
+#include "obs/gs/gs-helper.hpp"
+
+// Pooled render targets that have not been leased for this long are destroyed.
+static constexpr std::chrono::seconds idle_lifetime = std::chrono::seconds(10);
+
+streamfx::obs::gs::rendertarget_pool::~rendertarget_pool()
+{
+	obs_remove_tick_callback(tick, this);
+	_statistics.reset();
+
+	// Leases that are still active delete their render target themselves once released.
+	std::map<key_t, std::list<entry_t>> free;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		std::swap(free, _free);
+	}
+	auto gctx = streamfx::obs::gs::context();
+	free.clear();
+}
+
+streamfx::obs::gs::rendertarget_pool::rendertarget_pool()
+	: _lock(), _free(), _elapsed(0), _hits(0), _misses(0), _trimmed(0), _leased(0), _leased_bytes(0), _pooled(0),
+	  _pooled_bytes(0), _statistics()
+{
+	if (auto stats = ::streamfx::statistics::instance(); stats) {
+		_statistics = stats->add("rendertarget_pool", [this](obs_data_t* data) {
+			std::lock_guard<std::mutex> lock(_lock);
+			obs_data_set_int(data, "hits", static_cast<long long>(_hits));
+			obs_data_set_int(data, "misses", static_cast<long long>(_misses));
+			obs_data_set_int(data, "trimmed", static_cast<long long>(_trimmed));
+			obs_data_set_int(data, "leased", static_cast<long long>(_leased));
+			obs_data_set_int(data, "leased_memory", static_cast<long long>(_leased_bytes));
+			obs_data_set_int(data, "pooled", static_cast<long long>(_pooled));
+			obs_data_set_int(data, "pooled_memory", static_cast<long long>(_pooled_bytes));
+		});
+	}
+
+	obs_add_tick_callback(tick, this);
+}
+
+std::shared_ptr<streamfx::obs::gs::rendertarget> streamfx::obs::gs::rendertarget_pool::acquire(
+	uint32_t width, uint32_t height, gs_color_format color_format, gs_zstencil_format zstencil_format)
+{
+	key_t                                            key{width, height, color_format, zstencil_format};
+	std::unique_ptr<streamfx::obs::gs::rendertarget> rt;
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		if (auto kv = _free.find(key); (kv != _free.end()) && !kv->second.empty()) {
+			// Reuse the most recently released one, it is the most likely to still be resident.
+			rt = std::move(kv->second.back().rendertarget);
+			kv->second.pop_back();
+			_pooled--;
+			_pooled_bytes -= memory_size(key);
+			_hits++;
+		} else {
+			_misses++;
+		}
+		_leased++;
+		_leased_bytes += memory_size(key);
+	}
+
+	if (!rt) {
+		try {
+			rt = std::make_unique<streamfx::obs::gs::rendertarget>(color_format, zstencil_format);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(_lock);
+			_leased--;
+			_leased_bytes -= memory_size(key);
+			throw;
+		}
+	}
+
+	// The lease only holds a weak reference, so that it may outlive the pool.
+	std::weak_ptr<streamfx::obs::gs::rendertarget_pool> self    = weak_from_this();
+	auto                                                deleter = [self, key](streamfx::obs::gs::rendertarget* ptr) {
+		if (auto pool = self.lock(); pool) {
+			pool->release(key, ptr);
+		} else {
+			delete ptr;
+		}
+	};
+	return std::shared_ptr<streamfx::obs::gs::rendertarget>(rt.release(), deleter);
+}
+
+std::shared_ptr<streamfx::obs::gs::rendertarget> streamfx::obs::gs::rendertarget_pool::lease(
+	uint32_t width, uint32_t height, gs_color_format color_format, gs_zstencil_format zstencil_format)
+{
+	if (auto pool = instance(); pool) {
+		return pool->acquire(width, height, color_format, zstencil_format);
+	} else {
+		return std::make_shared<streamfx::obs::gs::rendertarget>(color_format, zstencil_format);
+	}
+}
+
+void streamfx::obs::gs::rendertarget_pool::trim(std::chrono::milliseconds unused_for)
+{
+	auto                                                        now = std::chrono::steady_clock::now();
+	std::list<std::unique_ptr<streamfx::obs::gs::rendertarget>> victims;
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		for (auto kv = _free.begin(); kv != _free.end();) {
+			// Entries are ordered by the time they were released, oldest first.
+			auto& list = kv->second;
+			while (!list.empty() && ((now - list.front().released) >= unused_for)) {
+				victims.push_back(std::move(list.front().rendertarget));
+				list.pop_front();
+				_pooled--;
+				_pooled_bytes -= memory_size(kv->first);
+				_trimmed++;
+			}
+
+			if (list.empty()) {
+				kv = _free.erase(kv);
+			} else {
+				kv++;
+			}
+		}
+	}
+
+	// Destroy them without holding the lock.
+	if (!victims.empty()) {
+		auto gctx = streamfx::obs::gs::context();
+		victims.clear();
+	}
+}
+
+void streamfx::obs::gs::rendertarget_pool::release(key_t key, streamfx::obs::gs::rendertarget* rendertarget)
+{
+	std::unique_ptr<streamfx::obs::gs::rendertarget> rt{rendertarget};
+
+	std::lock_guard<std::mutex> lock(_lock);
+	_leased--;
+	_leased_bytes -= memory_size(key);
+	_pooled++;
+	_pooled_bytes += memory_size(key);
+	_free[key].push_back({std::move(rt), std::chrono::steady_clock::now()});
+}
+
+size_t streamfx::obs::gs::rendertarget_pool::memory_size(const key_t& key)
+{
+	size_t pixels = static_cast<size_t>(std::get<0>(key)) * static_cast<size_t>(std::get<1>(key));
+
+	size_t zstencil_bits = 0;
+	switch (std::get<3>(key)) {
+	case GS_Z16:
+		zstencil_bits = 16;
+		break;
+	case GS_Z24_S8:
+	case GS_Z32F:
+		zstencil_bits = 32;
+		break;
+	case GS_Z32F_S8X24:
+		zstencil_bits = 64;
+		break;
+	default:
+		break;
+	}
+
+	return pixels * (gs_get_format_bpp(std::get<2>(key)) + zstencil_bits) / 8;
+}
+
+void streamfx::obs::gs::rendertarget_pool::tick(void* ptr, float seconds)
+{
+	auto self = reinterpret_cast<streamfx::obs::gs::rendertarget_pool*>(ptr);
+
+	// Only look for idle render targets once a second, there is no need to be precise.
+	self->_elapsed += seconds;
+	if (self->_elapsed >= 1.f) {
+		self->_elapsed = 0;
+		self->trim(idle_lifetime);
+	}
+}
+
+static std::shared_ptr<streamfx::obs::gs::rendertarget_pool> _instance = nullptr;
+
+void streamfx::obs::gs::rendertarget_pool::initialize()
+{
+	if (!_instance) {
+		_instance = std::make_shared<streamfx::obs::gs::rendertarget_pool>();
+	}
+}
+
+void streamfx::obs::gs::rendertarget_pool::finalize()
+{
+	_instance.reset();
+}
+
+std::shared_ptr<streamfx::obs::gs::rendertarget_pool> streamfx::obs::gs::rendertarget_pool::instance()
+{
+	return _instance;
+}
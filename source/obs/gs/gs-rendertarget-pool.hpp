@@ -0,0 +1,98 @@
+// Copyright (c) 2022 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include "gs-rendertarget.hpp"
+
+#include "warning-disable.hpp"
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include "warning-enable.hpp"
+
+namespace streamfx::obs::gs {
+	/** Shared render targets for intermediate results, which only need to exist for a single render.
+	 *
+	 * Render targets are leased for a specific size and format, and return to the pool once the last reference to the
+	 * lease is released. Render targets that have not been leased for a while are destroyed to free their memory.
+	 */
+	class rendertarget_pool : public std::enable_shared_from_this<rendertarget_pool> {
+		typedef std::tuple<uint32_t, uint32_t, gs_color_format, gs_zstencil_format> key_t;
+		typedef std::chrono::steady_clock::time_point                             timestamp_t;
+
+		struct entry_t {
+			std::unique_ptr<streamfx::obs::gs::rendertarget> rendertarget;
+			timestamp_t                                      released;
+		};
+
+		std::mutex                          _lock;
+		std::map<key_t, std::list<entry_t>> _free;
+		float                               _elapsed;
+
+		uint64_t              _hits;
+		uint64_t              _misses;
+		uint64_t              _trimmed;
+		size_t                _leased;
+		size_t                _leased_bytes;
+		size_t                _pooled;
+		size_t                _pooled_bytes;
+		std::shared_ptr<void> _statistics;
+
+		public:
+		~rendertarget_pool();
+		rendertarget_pool();
+
+		public:
+		/** Lease a render target of the given size and format.
+		 *
+		 * The render target is returned to the pool once the returned pointer and all copies of it are released, so it
+		 * must not be kept around for longer than the current render.
+		 */
+		std::shared_ptr<streamfx::obs::gs::rendertarget> acquire(uint32_t width, uint32_t height,
+																 gs_color_format    color_format,
+																 gs_zstencil_format zstencil_format);
+
+		/** Lease a render target from the pool, or create a private one if there is no pool.
+		 */
+		static std::shared_ptr<streamfx::obs::gs::rendertarget> lease(uint32_t width, uint32_t height,
+																	  gs_color_format    color_format,
+																	  gs_zstencil_format zstencil_format);
+
+		/** Destroy all pooled render targets that have not been leased for the given duration.
+		 */
+		void trim(std::chrono::milliseconds unused_for);
+
+		private:
+		void release(key_t key, streamfx::obs::gs::rendertarget* rendertarget);
+
+		static size_t memory_size(const key_t& key);
+
+		static void tick(void* ptr, float seconds);
+
+		public /* Singleton */:
+		static void                                                 initialize();
+		static void                                                 finalize();
+		static std::shared_ptr<streamfx::obs::gs::rendertarget_pool> instance();
+	};
+} // namespace streamfx::obs::gs
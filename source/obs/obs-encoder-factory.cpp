@@ -18,3 +18,30 @@
  */
 
 #include "obs-encoder-factory.hpp"
+#include "statistics.hpp"
+
+streamfx::obs::encoder_instance::encoder_instance(obs_data_t* settings, obs_encoder_t* self, bool is_hw)
+	: _self(self), _statistics(),
+	  _encode_timing(::streamfx::util::profiler::create(std::string("'") + obs_encoder_get_name(self) + "' encode"))
+{}
+
+void streamfx::obs::encoder_instance::register_statistics()
+{
+	auto stats = ::streamfx::statistics::instance();
+	if (!stats) {
+		return;
+	}
+
+	_statistics = stats->add("encoders", [this](obs_data_t* data) {
+		obs_data_set_string(data, "name", obs_encoder_get_name(_self));
+		obs_data_set_string(data, "id", obs_encoder_get_id(_self));
+		obs_data_set_bool(data, "active", obs_encoder_active(_self));
+		::streamfx::statistics::write_profiler(data, "encode", _encode_timing);
+		statistics(data);
+	});
+}
+
+void streamfx::obs::encoder_instance::unregister_statistics()
+{
+	_statistics.reset();
+}
@@ -20,14 +20,19 @@
 #pragma once
 #include "common.hpp"
 #include "plugin.hpp"
+#include "util/util-logging.hpp"
 
 namespace streamfx::obs {
 	class encoder_instance {
 		protected:
 		obs_encoder_t* _self;
 
+		private:
+		std::shared_ptr<void>                       _statistics;
+		std::shared_ptr<::streamfx::util::profiler> _encode_timing;
+
 		public:
-		encoder_instance(obs_data_t* settings, obs_encoder_t* self, bool is_hw) : _self(self) {}
+		encoder_instance(obs_data_t* settings, obs_encoder_t* self, bool is_hw);
 		virtual ~encoder_instance(){};
 
 		virtual void migrate(obs_data_t* settings, uint64_t version) {}
@@ -87,6 +92,24 @@ namespace streamfx::obs {
 		{
 			return _self;
 		}
+
+		public /* Statistics */:
+		/** Add instance specific state to the live statistics.
+		 *
+		 * Called from whichever thread collects the statistics, so only touch state that is safe to read from there.
+		 */
+		virtual void statistics(obs_data_t* data) {}
+
+		void register_statistics();
+
+		void unregister_statistics();
+
+		/** Time distribution of encode calls, as measured by the factory around every call.
+		 */
+		const std::shared_ptr<::streamfx::util::profiler>& get_encode_timing()
+		{
+			return _encode_timing;
+		}
 	};
 
 	template<class _factory, typename _instance>
@@ -191,8 +214,12 @@ namespace streamfx::obs {
 		static void* _create(obs_data_t* settings, obs_encoder_t* encoder) noexcept
 		{
 			try {
-				auto* fac = reinterpret_cast<factory_t*>(obs_encoder_get_type_data(encoder));
-				return fac->create(settings, encoder, false);
+				auto* fac      = reinterpret_cast<factory_t*>(obs_encoder_get_type_data(encoder));
+				auto  instance = fac->create(settings, encoder, false);
+				if (instance) {
+					reinterpret_cast<encoder_instance*>(instance)->register_statistics();
+				}
+				return instance;
 			} catch (const std::exception& ex) {
 				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 				return nullptr;
@@ -207,7 +234,11 @@ namespace streamfx::obs {
 			try {
 				auto* fac = reinterpret_cast<factory_t*>(obs_encoder_get_type_data(encoder));
 				try {
-					return fac->create(settings, encoder, true);
+					auto instance = fac->create(settings, encoder, true);
+					if (instance) {
+						reinterpret_cast<encoder_instance*>(instance)->register_statistics();
+					}
+					return instance;
 				} catch (...) {
 					return obs_encoder_create_rerouted(encoder, fac->_info_fallback.id);
 				}
@@ -278,8 +309,10 @@ namespace streamfx::obs {
 		static void _destroy(void* data) noexcept
 		{
 			try {
-				if (data)
+				if (data) {
+					reinterpret_cast<instance_t*>(data)->unregister_statistics();
 					delete reinterpret_cast<instance_t*>(data);
+				}
 			} catch (const std::exception& ex) {
 				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 			} catch (...) {
@@ -309,14 +342,17 @@ namespace streamfx::obs {
 							bool* received_packet) noexcept
 		{
 			try {
-				if (data)
-					return reinterpret_cast<encoder_instance*>(data)->encode_video(frame, packet, received_packet);
+				if (data) {
+					auto priv = reinterpret_cast<encoder_instance*>(data);
+					::streamfx::util::profiler::instance timing{priv->get_encode_timing()};
+					return priv->encode_video(frame, packet, received_packet);
+				}
 				return false;
 			} catch (const std::exception& ex) {
-				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 				return false;
 			} catch (...) {
-				DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 				return false;
 			}
 		}
@@ -325,15 +361,17 @@ namespace streamfx::obs {
 									struct encoder_packet* packet, bool* received_packet) noexcept
 		{
 			try {
-				if (data)
-					return reinterpret_cast<encoder_instance*>(data)->encode_video(handle, pts, lock_key, next_key,
-																				   packet, received_packet);
+				if (data) {
+					auto priv = reinterpret_cast<encoder_instance*>(data);
+					::streamfx::util::profiler::instance timing{priv->get_encode_timing()};
+					return priv->encode_video(handle, pts, lock_key, next_key, packet, received_packet);
+				}
 				return false;
 			} catch (const std::exception& ex) {
-				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 				return false;
 			} catch (...) {
-				DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 				return false;
 			}
 		}
@@ -0,0 +1,111 @@
+// Copyright (C) 2022 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#include "obs-frame-graph.hpp"
+#include "statistics.hpp"
+#include "obs/obs-source.hpp"
+
+streamfx::obs::frame_graph::~frame_graph()
+{
+	_statistics.reset();
+}
+
+streamfx::obs::frame_graph::frame_graph() : _lock(), _nodes(), _hits(0), _misses(0), _statistics()
+{
+	if (auto stats = ::streamfx::statistics::instance(); stats) {
+		_statistics = stats->add("frame_graph", [this](obs_data_t* data) {
+			std::lock_guard<std::mutex> lock(_lock);
+			obs_data_set_int(data, "nodes", static_cast<long long>(_nodes.size()));
+			obs_data_set_int(data, "hits", static_cast<long long>(_hits));
+			obs_data_set_int(data, "misses", static_cast<long long>(_misses));
+		});
+	}
+}
+
+std::shared_ptr<void> streamfx::obs::frame_graph::add(obs_source_t* filter, output_t output)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	_nodes.insert_or_assign(filter, output);
+
+	// The handle only holds a weak reference, so that instances may outlive the frame graph.
+	std::weak_ptr<streamfx::obs::frame_graph> self = instance();
+	return std::shared_ptr<void>(nullptr, [self, filter](void*) {
+		if (auto strong = self.lock(); strong) {
+			std::lock_guard<std::mutex> lock(strong->_lock);
+			strong->_nodes.erase(filter);
+		}
+	});
+}
+
+std::shared_ptr<streamfx::obs::gs::texture> streamfx::obs::frame_graph::input(obs_source_t* filter, uint32_t width,
+																			   uint32_t height)
+{
+	obs_source_t* parent = obs_filter_get_parent(filter);
+	obs_source_t* target = obs_filter_get_target(filter);
+
+	// Only filters can be nodes, and libOBS skips disabled filters on its own.
+	if (!target || (target == parent) || !obs_source_enabled(target)) {
+		return nullptr;
+	}
+
+	output_t                output;
+	::streamfx::obs::source reference;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		auto                        found = _nodes.find(target);
+		if (found == _nodes.end()) {
+			_misses++;
+			return nullptr;
+		}
+
+		// Keep the node alive while it renders, nodes are only unregistered once their source is destroyed.
+		reference = ::streamfx::obs::source{target, true};
+		if (!reference) {
+			return nullptr;
+		}
+		output = found->second;
+	}
+
+	auto texture = output();
+	if (!texture || (texture->get_width() != width) || (texture->get_height() != height)) {
+		std::lock_guard<std::mutex> lock(_lock);
+		_misses++;
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(_lock);
+	_hits++;
+	return texture;
+}
+
+static std::shared_ptr<streamfx::obs::frame_graph> _instance = nullptr;
+
+void streamfx::obs::frame_graph::initialize()
+{
+	if (!_instance) {
+		_instance = std::make_shared<streamfx::obs::frame_graph>();
+	}
+}
+
+void streamfx::obs::frame_graph::finalize()
+{
+	_instance.reset();
+}
+
+std::shared_ptr<streamfx::obs::frame_graph> streamfx::obs::frame_graph::instance()
+{
+	return _instance;
+}
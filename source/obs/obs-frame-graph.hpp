@@ -0,0 +1,73 @@
+// Copyright (C) 2022 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#pragma once
+#include "common.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+#include "warning-disable.hpp"
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "warning-enable.hpp"
+
+namespace streamfx::obs {
+	/** Direct hand-off of rendered output between consecutive StreamFX filters.
+	 *
+	 * libOBS renders a filter chain by having each filter draw the filter above it into a texrender, which the filter
+	 * then copies into its own input cache. Filters that keep their result in a texture register themselves as a node,
+	 * so that a StreamFX filter below them can take that texture as its input instead, skipping both the texrender and
+	 * the capture pass. Anything else above a filter is still captured the usual way.
+	 */
+	class frame_graph {
+		public:
+		/** Render the output of a node for the current frame, or return nullptr if it can't.
+		 *
+		 * Must not draw to the current render target, and must not skip the filter, as it is called from the filter below.
+		 */
+		typedef std::function<std::shared_ptr<streamfx::obs::gs::texture>()> output_t;
+
+		private:
+		std::mutex                        _lock;
+		std::map<obs_source_t*, output_t> _nodes;
+		uint64_t                          _hits;
+		uint64_t                          _misses;
+		std::shared_ptr<void>             _statistics;
+
+		public:
+		~frame_graph();
+		frame_graph();
+
+		public:
+		/** Register a filter as a node that can hand its output to the filter below it.
+		 *
+		 * @return Handle that keeps the node registered, releasing it unregisters the node.
+		 */
+		std::shared_ptr<void> add(obs_source_t* filter, output_t output);
+
+		/** Retrieve the output of the StreamFX filter directly above 'filter'.
+		 *
+		 * @return The output texture of the node above, or nullptr if the input has to be captured the usual way.
+		 */
+		std::shared_ptr<streamfx::obs::gs::texture> input(obs_source_t* filter, uint32_t width, uint32_t height);
+
+		public /* Singleton */:
+		static void                                        initialize();
+		static void                                        finalize();
+		static std::shared_ptr<streamfx::obs::frame_graph> instance();
+	};
+} // namespace streamfx::obs
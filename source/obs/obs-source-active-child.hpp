@@ -18,6 +18,7 @@
 
 #pragma once
 #include "common.hpp"
+#include "obs-source-graph.hpp"
 #include "obs-source.hpp"
 #include "obs-tools.hpp"
 #include "obs-weak-source.hpp"
@@ -34,6 +35,9 @@ namespace streamfx::obs {
 			auto child  = _child.lock();
 			if (parent && child) {
 				obs_source_remove_active_child(parent, child);
+				if (auto graph = ::streamfx::obs::source_graph::instance(); graph) {
+					graph->invalidate(parent);
+				}
 			}
 		}
 		source_active_child(::streamfx::obs::source const& parent, ::streamfx::obs::source const& child)
@@ -44,6 +48,9 @@ namespace streamfx::obs {
 			} else if (!obs_source_add_active_child(parent, child)) {
 				throw std::runtime_error("Child contains Parent");
 			}
+			if (auto graph = ::streamfx::obs::source_graph::instance(); graph) {
+				graph->invalidate(parent);
+			}
 		}
 	};
 } // namespace streamfx::obs
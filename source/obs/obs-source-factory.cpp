@@ -19,3 +19,65 @@
 // SOFTWARE.
 
 #include "obs-source-factory.hpp"
+#include "statistics.hpp"
+
+#ifdef ENABLE_PROFILING
+static constexpr std::string_view timing_names[] = {
+	"video_tick", "video_render", "filter_video", "filter_audio", "audio_render",
+};
+#endif
+
+streamfx::obs::source_instance::source_instance(obs_data_t* settings, obs_source_t* source)
+	: _self(source, false, false), _statistics()
+{
+#ifdef ENABLE_PROFILING
+	for (size_t idx = 0; idx < _timings.size(); idx++) {
+		_timings[idx] = ::streamfx::util::profiler::create(std::string("'") + _self.name().data() + "' "
+															+ timing_names[idx].data());
+	}
+#endif
+}
+
+streamfx::obs::source_instance::~source_instance()
+{
+#ifdef ENABLE_PROFILING
+	// Summarize where this instance spent its time, skipping callbacks that were never called.
+	for (size_t idx = 0; idx < _timings.size(); idx++) {
+		auto& timing = _timings[idx];
+		if (timing->count() == 0) {
+			continue;
+		}
+
+		DLOG_INFO("'%s' %s: %8.3lfµs, 95.0%% < %8.3lfµs, 99.0%% < %8.3lfµs, 99.9%% < %8.3lfµs, %llu calls.",
+				  _self.name().data(), timing_names[idx].data(), timing->average_duration() / 1000.,
+				  timing->percentile(0.950).count() / 1000., timing->percentile(0.990).count() / 1000.,
+				  timing->percentile(0.999).count() / 1000., static_cast<unsigned long long>(timing->count()));
+	}
+#endif
+}
+
+void streamfx::obs::source_instance::register_statistics()
+{
+	auto stats = ::streamfx::statistics::instance();
+	if (!stats) {
+		return;
+	}
+
+	_statistics = stats->add("sources", [this](obs_data_t* data) {
+		obs_data_set_string(data, "name", _self.name().data());
+		obs_data_set_string(data, "id", _self.id().data());
+		obs_data_set_bool(data, "active", obs_source_active(_self.get()));
+		obs_data_set_bool(data, "showing", obs_source_showing(_self.get()));
+#ifdef ENABLE_PROFILING
+		for (size_t idx = 0; idx < _timings.size(); idx++) {
+			::streamfx::statistics::write_profiler(data, timing_names[idx], _timings[idx]);
+		}
+#endif
+		statistics(data);
+	});
+}
+
+void streamfx::obs::source_instance::unregister_statistics()
+{
+	_statistics.reset();
+}
@@ -21,6 +21,15 @@
 #pragma once
 #include "common.hpp"
 #include "obs-source.hpp"
+#include "util/util-logging.hpp"
+
+#ifdef ENABLE_PROFILING
+// Time the rest of the calling scope into the matching profiler of the instance.
+#define D_TIME_CALLBACK(x) \
+	::streamfx::util::profiler::instance _timing(reinterpret_cast<_instance*>(data)->get_timing(_instance::timing::x))
+#else
+#define D_TIME_CALLBACK(x)
+#endif
 
 namespace streamfx::obs {
 	template<class _factory, typename _instance>
@@ -161,7 +170,11 @@ namespace streamfx::obs {
 		static void* _create(obs_data_t* settings, obs_source_t* source) noexcept
 		{
 			try {
-				return reinterpret_cast<_factory*>(obs_source_get_type_data(source))->create(settings, source);
+				auto instance = reinterpret_cast<_factory*>(obs_source_get_type_data(source))->create(settings, source);
+				if (instance) {
+					reinterpret_cast<_instance*>(instance)->register_statistics();
+				}
+				return instance;
 			} catch (const std::exception& ex) {
 				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 				return nullptr;
@@ -202,8 +215,10 @@ namespace streamfx::obs {
 		static void _destroy(void* data) noexcept
 		{
 			try {
-				if (data)
+				if (data) {
+					reinterpret_cast<_instance*>(data)->unregister_statistics();
 					delete reinterpret_cast<_instance*>(data);
+				}
 			} catch (const std::exception& ex) {
 				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 			} catch (...) {
@@ -251,37 +266,43 @@ namespace streamfx::obs {
 		static void _video_tick(void* data, float seconds) noexcept
 		{
 			try {
-				if (data)
+				if (data) {
+					D_TIME_CALLBACK(VIDEO_TICK);
 					reinterpret_cast<_instance*>(data)->video_tick(seconds);
+				}
 			} catch (const std::exception& ex) {
-				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 			} catch (...) {
-				DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 			}
 		}
 
 		static void _video_render(void* data, gs_effect_t* effect) noexcept
 		{
 			try {
-				if (data)
+				if (data) {
+					D_TIME_CALLBACK(VIDEO_RENDER);
 					reinterpret_cast<_instance*>(data)->video_render(effect);
+				}
 			} catch (const std::exception& ex) {
-				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 			} catch (...) {
-				DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 			}
 		}
 
 		static void _video_render_filter(void* data, gs_effect_t* effect) noexcept
 		{
 			try {
-				if (data)
+				if (data) {
+					D_TIME_CALLBACK(VIDEO_RENDER);
 					reinterpret_cast<_instance*>(data)->video_render(effect);
+				}
 			} catch (const std::exception& ex) {
-				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 				obs_source_skip_video_filter(reinterpret_cast<_instance*>(data)->get());
 			} catch (...) {
-				DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 				obs_source_skip_video_filter(reinterpret_cast<_instance*>(data)->get());
 			}
 		}
@@ -289,14 +310,16 @@ namespace streamfx::obs {
 		static struct obs_source_frame* _filter_video(void* data, struct obs_source_frame* frame) noexcept
 		{
 			try {
-				if (data)
+				if (data) {
+					D_TIME_CALLBACK(FILTER_VIDEO);
 					return reinterpret_cast<_instance*>(data)->filter_video(frame);
+				}
 				return frame;
 			} catch (const std::exception& ex) {
-				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 				return frame;
 			} catch (...) {
-				DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 				return frame;
 			}
 		}
@@ -305,14 +328,16 @@ namespace streamfx::obs {
 		static struct obs_audio_data* _filter_audio(void* data, struct obs_audio_data* frame) noexcept
 		{
 			try {
-				if (data)
+				if (data) {
+					D_TIME_CALLBACK(FILTER_AUDIO);
 					return reinterpret_cast<_instance*>(data)->filter_audio(frame);
+				}
 				return frame;
 			} catch (const std::exception& ex) {
-				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 				return frame;
 			} catch (...) {
-				DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 				return frame;
 			}
 		}
@@ -321,15 +346,17 @@ namespace streamfx::obs {
 								  uint32_t mixers, std::size_t channels, std::size_t sample_rate) noexcept
 		{
 			try {
-				if (data)
+				if (data) {
+					D_TIME_CALLBACK(AUDIO_RENDER);
 					return reinterpret_cast<_instance*>(data)->audio_render(ts_out, audio_output, mixers, channels,
 																			sample_rate);
+				}
 				return false;
 			} catch (const std::exception& ex) {
-				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 				return false;
 			} catch (...) {
-				DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 				return false;
 			}
 		}
@@ -342,10 +369,10 @@ namespace streamfx::obs {
 					return reinterpret_cast<_instance*>(data)->audio_mix(ts_out, audio_output, channels, sample_rate);
 				return false;
 			} catch (const std::exception& ex) {
-				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 				return false;
 			} catch (...) {
-				DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+				P_LOG_ERROR_LIMITED("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 				return false;
 			}
 		}
@@ -849,12 +876,31 @@ namespace streamfx::obs {
 	};
 
 	class source_instance {
+#ifdef ENABLE_PROFILING
+		public:
+		enum class timing : size_t {
+			VIDEO_TICK,
+			VIDEO_RENDER,
+			FILTER_VIDEO,
+			FILTER_AUDIO,
+			AUDIO_RENDER,
+			_COUNT,
+		};
+#endif
+
 		protected:
 		::streamfx::obs::source _self;
 
+		private:
+		std::shared_ptr<void> _statistics;
+
+#ifdef ENABLE_PROFILING
+		std::array<std::shared_ptr<::streamfx::util::profiler>, static_cast<size_t>(timing::_COUNT)> _timings;
+#endif
+
 		public:
-		source_instance(obs_data_t* settings, obs_source_t* source) : _self(source, false, false) {}
-		virtual ~source_instance(){};
+		source_instance(obs_data_t* settings, obs_source_t* source);
+		virtual ~source_instance();
 
 		virtual ::streamfx::obs::source get()
 		{
@@ -980,6 +1026,29 @@ namespace streamfx::obs {
 		{
 			return nullptr;
 		};
+
+		public /* Instance > Statistics */:
+		/** Add instance specific state to the live statistics.
+		 *
+		 * Called from whichever thread collects the statistics, so only touch state that is safe to read from there.
+		 */
+		virtual void statistics(obs_data_t* data) {}
+
+		void register_statistics();
+
+		void unregister_statistics();
+
+#ifdef ENABLE_PROFILING
+		public /* Instance > Profiling */:
+		/** Time distribution of a callback, as measured by the factory around every call to it.
+		 */
+		const std::shared_ptr<::streamfx::util::profiler>& get_timing(timing type)
+		{
+			return _timings[static_cast<size_t>(type)];
+		}
+#endif
 	};
 
 } // namespace streamfx::obs
+
+#undef D_TIME_CALLBACK
@@ -0,0 +1,317 @@
+// Copyright (C) 2022 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#include "obs-source-graph.hpp"
+#include "util/util-logging.hpp"
+
+#include "warning-disable.hpp"
+#include <vector>
+#include "warning-enable.hpp"
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<obs::source_graph> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+// Transitions switch their active children internally, without emitting any signal, so neither their children nor
+// anything reached through them may be cached.
+static bool is_volatile(obs_source_t* source)
+{
+	return obs_source_get_type(source) == OBS_SOURCE_TYPE_TRANSITION;
+}
+
+streamfx::obs::source_graph::~source_graph()
+{
+	if (auto osi = obs_get_signal_handler(); osi) {
+		signal_handler_disconnect(osi, "source_create", &on_source_create, this);
+		signal_handler_disconnect(osi, "source_destroy", &on_source_destroy, this);
+	}
+
+	obs_enum_all_sources(
+		[](void* param, obs_source_t* source) {
+			reinterpret_cast<::streamfx::obs::source_graph*>(param)->disconnect(source);
+			return true;
+		},
+		this);
+}
+
+streamfx::obs::source_graph::source_graph()
+	: _lock(), _children(), _parents(), _reachable(), _reachable_generation(0), _generation(0)
+{
+	auto osi = obs_get_signal_handler();
+	signal_handler_connect(osi, "source_create", &on_source_create, this);
+	signal_handler_connect(osi, "source_destroy", &on_source_destroy, this);
+
+	// Sources that already exist never signal their creation.
+	obs_enum_all_sources(
+		[](void* param, obs_source_t* source) {
+			reinterpret_cast<::streamfx::obs::source_graph*>(param)->connect(source);
+			return true;
+		},
+		this);
+}
+
+bool streamfx::obs::source_graph::contains(obs_source_t* haystack, obs_source_t* needle)
+{
+	if (!haystack || !needle) {
+		return false;
+	} else if (haystack == needle) {
+		return true;
+	}
+
+	uint64_t generation;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		generation = _generation.load();
+		if (_reachable_generation != generation) {
+			_reachable.clear();
+			_reachable_generation = generation;
+		}
+
+		if (auto found = _reachable.find(haystack); found != _reachable.end()) {
+			return found->second.count(needle) != 0;
+		}
+	}
+
+	// Walk the graph without holding the lock, as enumerating children calls into libOBS.
+	std::set<obs_source_t*>                    reachable;
+	std::vector<::streamfx::obs::weak_source> queue;
+	bool                                      cacheable = !is_volatile(haystack);
+	for (auto& kv : children(haystack)) {
+		if (reachable.insert(kv.first).second) {
+			queue.push_back(kv.second);
+		}
+	}
+	while (!queue.empty()) {
+		auto source = queue.back().lock();
+		queue.pop_back();
+		if (!source) {
+			continue;
+		} else if (is_volatile(source.get())) {
+			cacheable = false;
+		}
+
+		for (auto& kv : children(source.get())) {
+			if (reachable.insert(kv.first).second) {
+				queue.push_back(kv.second);
+			}
+		}
+	}
+
+	bool found = reachable.count(needle) != 0;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		if (cacheable && (_generation.load() == generation) && (_reachable_generation == generation)) {
+			_reachable.emplace(haystack, std::move(reachable));
+		}
+	}
+	return found;
+}
+
+void streamfx::obs::source_graph::invalidate(obs_source_t* source)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	if (auto found = _children.find(source); found != _children.end()) {
+		for (auto& kv : found->second) {
+			if (auto parents = _parents.find(kv.first); parents != _parents.end()) {
+				parents->second.erase(source);
+				if (parents->second.empty()) {
+					_parents.erase(parents);
+				}
+			}
+		}
+		_children.erase(found);
+	}
+	_generation++;
+}
+
+uint64_t streamfx::obs::source_graph::generation()
+{
+	return _generation.load();
+}
+
+streamfx::obs::source_graph::children_t streamfx::obs::source_graph::children(obs_source_t* source)
+{
+	uint64_t generation;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		if (auto found = _children.find(source); found != _children.end()) {
+			return found->second;
+		}
+		generation = _generation.load();
+	}
+
+	// Enumerate the direct children: every child in the full tree that has this source as its parent, which includes
+	// currently inactive children such as the idle side of a transition, filters and, for scenes and groups, all items.
+	struct enum_data_t {
+		obs_source_t* parent;
+		children_t    list;
+	} data{source, {}};
+	auto add_child = [](obs_source_t* parent, obs_source_t* child, void* param) {
+		try {
+			// The full tree also contains the children of children, which belong to their own parent.
+			auto data = reinterpret_cast<enum_data_t*>(param);
+			if (parent == data->parent) {
+				data->list.emplace(child, ::streamfx::obs::weak_source{child});
+			}
+		} catch (...) {
+			// The child is being destroyed, and no longer needs to be tracked.
+		}
+	};
+	auto add_item = [](obs_scene_t*, obs_sceneitem_t* item, void* param) {
+		try {
+			obs_source_t* child = obs_sceneitem_get_source(item);
+			reinterpret_cast<enum_data_t*>(param)->list.emplace(child, ::streamfx::obs::weak_source{child});
+		} catch (...) {
+		}
+		return true;
+	};
+	obs_source_enum_full_tree(source, add_child, &data);
+	obs_source_enum_filters(source, add_child, &data);
+	if (auto scene = obs_scene_from_source(source); scene) {
+		obs_scene_enum_items(scene, add_item, &data);
+	} else if (auto group = obs_group_from_source(source); group) {
+		obs_scene_enum_items(group, add_item, &data);
+	}
+
+	// Only cache the result if nothing changed while enumerating, it may already be outdated otherwise.
+	if (is_volatile(source)) {
+		return data.list;
+	}
+	std::lock_guard<std::mutex> lock(_lock);
+	if (_generation.load() == generation) {
+		for (auto& kv : data.list) {
+			_parents[kv.first].insert(source);
+		}
+		_children.insert_or_assign(source, data.list);
+	}
+	return data.list;
+}
+
+void streamfx::obs::source_graph::forget(obs_source_t* source)
+{
+	invalidate(source);
+
+	// Remove the source from every parent that still lists it, so that a new source at the same address starts clean.
+	std::lock_guard<std::mutex> lock(_lock);
+	if (auto found = _parents.find(source); found != _parents.end()) {
+		for (auto parent : found->second) {
+			if (auto children = _children.find(parent); children != _children.end()) {
+				children->second.erase(source);
+			}
+		}
+		_parents.erase(found);
+	}
+	_generation++;
+}
+
+void streamfx::obs::source_graph::connect(obs_source_t* source)
+{
+	auto sh = obs_source_get_signal_handler(source);
+	signal_handler_connect(sh, "filter_add", &on_source_changed, this);
+	signal_handler_connect(sh, "filter_remove", &on_source_changed, this);
+	if (obs_source_get_type(source) == OBS_SOURCE_TYPE_SCENE) {
+		signal_handler_connect(sh, "item_add", &on_scene_changed, this);
+		signal_handler_connect(sh, "item_remove", &on_scene_changed, this);
+	}
+}
+
+void streamfx::obs::source_graph::disconnect(obs_source_t* source)
+{
+	auto sh = obs_source_get_signal_handler(source);
+	signal_handler_disconnect(sh, "filter_add", &on_source_changed, this);
+	signal_handler_disconnect(sh, "filter_remove", &on_source_changed, this);
+	if (obs_source_get_type(source) == OBS_SOURCE_TYPE_SCENE) {
+		signal_handler_disconnect(sh, "item_add", &on_scene_changed, this);
+		signal_handler_disconnect(sh, "item_remove", &on_scene_changed, this);
+	}
+}
+
+void streamfx::obs::source_graph::on_source_create(void* ptr, calldata_t* data) noexcept
+{
+	try {
+		obs_source_t* source = nullptr;
+		if (calldata_get_ptr(data, "source", &source); source) {
+			reinterpret_cast<::streamfx::obs::source_graph*>(ptr)->connect(source);
+		}
+	} catch (...) {
+		D_LOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+	}
+}
+
+void streamfx::obs::source_graph::on_source_destroy(void* ptr, calldata_t* data) noexcept
+{
+	try {
+		obs_source_t* source = nullptr;
+		if (calldata_get_ptr(data, "source", &source); source) {
+			reinterpret_cast<::streamfx::obs::source_graph*>(ptr)->forget(source);
+		}
+	} catch (...) {
+		D_LOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+	}
+}
+
+void streamfx::obs::source_graph::on_source_changed(void* ptr, calldata_t* data) noexcept
+{
+	try {
+		obs_source_t* source = nullptr;
+		if (calldata_get_ptr(data, "source", &source); source) {
+			reinterpret_cast<::streamfx::obs::source_graph*>(ptr)->invalidate(source);
+		}
+	} catch (...) {
+		D_LOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+	}
+}
+
+void streamfx::obs::source_graph::on_scene_changed(void* ptr, calldata_t* data) noexcept
+{
+	try {
+		obs_scene_t* scene = nullptr;
+		if (calldata_get_ptr(data, "scene", &scene); scene) {
+			reinterpret_cast<::streamfx::obs::source_graph*>(ptr)->invalidate(obs_scene_get_source(scene));
+		}
+	} catch (...) {
+		D_LOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+	}
+}
+
+static std::shared_ptr<streamfx::obs::source_graph> _instance = nullptr;
+
+void streamfx::obs::source_graph::initialize()
+{
+	if (!_instance) {
+		_instance = std::make_shared<streamfx::obs::source_graph>();
+	}
+}
+
+void streamfx::obs::source_graph::finalize()
+{
+	_instance.reset();
+}
+
+std::shared_ptr<streamfx::obs::source_graph> streamfx::obs::source_graph::instance()
+{
+	return _instance;
+}
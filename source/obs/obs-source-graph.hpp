@@ -0,0 +1,85 @@
+// Copyright (C) 2022 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#pragma once
+#include "common.hpp"
+#include "obs/obs-weak-source.hpp"
+
+#include "warning-disable.hpp"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include "warning-enable.hpp"
+
+namespace streamfx::obs {
+	/** Graph of which source references which other source.
+	 *
+	 * The direct children of a source (scene items, filters and all children in its full tree, active or not) are
+	 * enumerated once and cached until a signal of that source reports a change. Everything reachable from a source is
+	 * cached as well, until any part of the graph changes, so repeated reference loop checks cost a single lookup.
+	 *
+	 * Transitions change their active children without emitting a signal, so they are enumerated on every check, and
+	 * nothing reached through them is cached. Children added by other sources outside of StreamFX do not emit a signal
+	 * either, so those edges may be stale until the source is invalidated for another reason.
+	 */
+	class source_graph {
+		typedef std::map<obs_source_t*, ::streamfx::obs::weak_source> children_t;
+
+		std::mutex                                        _lock;
+		std::map<obs_source_t*, children_t>               _children;
+		std::map<obs_source_t*, std::set<obs_source_t*>> _parents;
+		std::map<obs_source_t*, std::set<obs_source_t*>> _reachable;
+		uint64_t                                          _reachable_generation;
+		std::atomic<uint64_t>                             _generation;
+
+		public:
+		~source_graph();
+		source_graph();
+
+		public:
+		/** Check if 'needle' is 'haystack' or can be reached from it.
+		 */
+		bool contains(obs_source_t* haystack, obs_source_t* needle);
+
+		/** Forget the cached children of a source, for changes that libOBS does not signal.
+		 */
+		void invalidate(obs_source_t* source);
+
+		/** Current generation of the graph, incremented on every change.
+		 */
+		uint64_t generation();
+
+		private:
+		children_t children(obs_source_t* source);
+
+		void forget(obs_source_t* source);
+
+		void connect(obs_source_t* source);
+		void disconnect(obs_source_t* source);
+
+		static void on_source_create(void* ptr, calldata_t* data) noexcept;
+		static void on_source_destroy(void* ptr, calldata_t* data) noexcept;
+		static void on_source_changed(void* ptr, calldata_t* data) noexcept;
+		static void on_scene_changed(void* ptr, calldata_t* data) noexcept;
+
+		public /* Singleton */:
+		static void                                        initialize();
+		static void                                        finalize();
+		static std::shared_ptr<streamfx::obs::source_graph> instance();
+	};
+} // namespace streamfx::obs
@@ -66,6 +66,7 @@ void streamfx::obs::source_tracker::source_destroy_handler(void* ptr, calldata_t
 			throw std::runtime_error("Missing 'source' parameter.");
 		}
 
+		self->remove_source(source);
 	} catch (const std::exception& ex) {
 		DLOG_ERROR("Event 'source_destroy' caused exception: %s", ex.what());
 	} catch (...) {
@@ -111,10 +112,7 @@ void streamfx::obs::source_tracker::insert_source(obs_source_t* source)
 	}
 
 	std::unique_lock<std::mutex> lock(_mutex);
-	_sources.insert({
-		std::string(name),
-		weak,
-	});
+	index_insert(name, weak, categorize(source));
 }
 
 void streamfx::obs::source_tracker::remove_source(obs_source_t* source)
@@ -124,28 +122,24 @@ void streamfx::obs::source_tracker::remove_source(obs_source_t* source)
 	// Lock read & write access to the map.
 	std::unique_lock<std::mutex> ul(_mutex);
 
-	// Try and remove the source by name.
+	// Try and remove the source by name. Names are not unique, as filters on different sources often share them, so
+	// the entry must actually belong to this source.
 	if (name != nullptr) {
 		auto found = _sources.find(std::string(name));
-		if (found != _sources.end()) {
-			_sources.erase(found);
+		if ((found != _sources.end()) && obs_weak_source_references_source(found->second.first.get(), source)) {
+			index_remove(found->first);
 			return;
 		}
 	}
 
-	// If that didn't work, try and remove it by handle.
+	// If that didn't work, try and remove it by handle. Sources that were never tracked, like those sharing their name
+	// with another source, are not found at all, which is fine.
 	for (auto iter = _sources.begin(); iter != _sources.end(); iter++) {
-		if (obs_weak_source_get_source(iter->second.get()) == source) {
-			_sources.erase(iter);
+		if (obs_weak_source_references_source(iter->second.first.get(), source)) {
+			index_remove(iter->first);
 			return;
 		}
 	}
-
-	// If that all failed, and the source is named, throw and report an error.
-	if (name) {
-		D_LOG_WARNING("Source '%s' was not tracked.", name);
-		throw std::runtime_error("Failed to find given source.");
-	}
 }
 
 void streamfx::obs::source_tracker::rename_source(std::string_view old_name, std::string_view new_name,
@@ -157,18 +151,62 @@ void streamfx::obs::source_tracker::rename_source(std::string_view old_name, std
 
 	std::unique_lock<std::mutex> ul(_mutex);
 	auto                         found = _sources.find(std::string(old_name));
-	if (found == _sources.end()) {
+	if ((found == _sources.end()) || !obs_weak_source_references_source(found->second.first.get(), source)) {
+		ul.unlock();
 		insert_source(source);
 		return;
 	}
 
 	// Insert at new key, remove old pair.
-	_sources.insert({new_name.data(), found->second});
+	auto entry = found->second;
+	index_remove(found->first);
+	index_insert(std::string(new_name), entry.first, entry.second);
+}
+
+void streamfx::obs::source_tracker::index_insert(const std::string& name, std::shared_ptr<obs_weak_source_t> weak,
+												 category categories)
+{
+	if (auto found = _sources.find(name); found != _sources.end()) {
+		// Filters often share their name with an input, which must stay listed under it while it exists.
+		if ((categories == category::NONE) && (found->second.second != category::NONE)
+			&& !obs_weak_source_expired(found->second.first.get())) {
+			return;
+		}
+		index_remove(name);
+	}
+
+	_sources.emplace(name, std::make_pair(weak, categories));
+	for (auto& kv : _indices) {
+		if (has(categories, kv.first)) {
+			kv.second.insert_or_assign(name, weak);
+		}
+	}
+	_generation++;
+}
+
+void streamfx::obs::source_tracker::index_remove(const std::string& name)
+{
+	auto found = _sources.find(name);
+	if (found == _sources.end()) {
+		return;
+	}
+
+	// Only erase the index entries of the source that is tracked under this name.
+	for (auto& kv : _indices) {
+		if (auto entry = kv.second.find(name); (entry != kv.second.end()) && (entry->second == found->second.first)) {
+			kv.second.erase(entry);
+		}
+	}
 	_sources.erase(found);
+	_generation++;
 }
 
-streamfx::obs::source_tracker::source_tracker() : _sources(), _mutex()
+streamfx::obs::source_tracker::source_tracker() : _sources(), _indices(), _names(), _generation(0), _mutex()
 {
+	for (auto cat : {category::SOURCE, category::VIDEO, category::AUDIO, category::TRANSITION, category::SCENE}) {
+		_indices.emplace(cat, index_t());
+	}
+
 	auto osi = obs_get_signal_handler();
 	signal_handler_connect(osi, "source_create", &source_create_handler, this);
 	signal_handler_connect(osi, "source_destroy", &source_destroy_handler, this);
@@ -193,6 +231,7 @@ streamfx::obs::source_tracker::~source_tracker()
 		signal_handler_disconnect(osi, "source_rename", &source_rename_handler, this);
 	}
 
+	this->_indices.clear();
 	this->_sources.clear();
 }
 
@@ -206,7 +245,7 @@ void streamfx::obs::source_tracker::enumerate(enumerate_cb_t ecb, filter_cb_t fc
 	}
 
 	for (auto kv : _clone) {
-		auto source = std::shared_ptr<obs_source_t>(obs_weak_source_get_source(kv.second.get()),
+		auto source = std::shared_ptr<obs_source_t>(obs_weak_source_get_source(kv.second.first.get()),
 													streamfx::obs::obs_source_deleter);
 		if (!source) {
 			continue;
@@ -226,6 +265,56 @@ void streamfx::obs::source_tracker::enumerate(enumerate_cb_t ecb, filter_cb_t fc
 	}
 }
 
+void streamfx::obs::source_tracker::enumerate(enumerate_cb_t ecb, category filter)
+{
+	// Only the index for the category is copied, which is usually a small part of all sources.
+	index_t _clone;
+	{
+		std::unique_lock<std::mutex> ul(_mutex);
+		if (auto found = _indices.find(filter); found != _indices.end()) {
+			_clone = found->second;
+		}
+	}
+
+	for (auto kv : _clone) {
+		auto source = std::shared_ptr<obs_source_t>(obs_weak_source_get_source(kv.second.get()),
+													streamfx::obs::obs_source_deleter);
+		if (!source) {
+			continue;
+		}
+
+		if (ecb) {
+			if (ecb(kv.first, source.get())) {
+				break;
+			}
+		}
+	}
+}
+
+streamfx::obs::source_tracker::names_t streamfx::obs::source_tracker::names(category filter)
+{
+	std::unique_lock<std::mutex> ul(_mutex);
+	auto                         generation = _generation.load();
+
+	auto& cached = _names[filter];
+	if (!cached.second || (cached.first != generation)) {
+		auto list = std::make_shared<std::vector<std::string>>();
+		if (auto found = _indices.find(filter); found != _indices.end()) {
+			list->reserve(found->second.size());
+			for (auto& kv : found->second) {
+				list->push_back(kv.first);
+			}
+		}
+		cached = {generation, list};
+	}
+	return cached.second;
+}
+
+uint64_t streamfx::obs::source_tracker::generation()
+{
+	return _generation.load();
+}
+
 bool streamfx::obs::source_tracker::filter_sources(std::string, obs_source_t* source)
 {
 	return (obs_source_get_type(source) != OBS_SOURCE_TYPE_INPUT);
@@ -253,6 +342,33 @@ bool streamfx::obs::source_tracker::filter_scenes(std::string, obs_source_t* sou
 	return (obs_source_get_type(source) != OBS_SOURCE_TYPE_SCENE);
 }
 
+streamfx::obs::source_tracker::category streamfx::obs::source_tracker::categorize(obs_source_t* source)
+{
+	category categories = category::NONE;
+	switch (obs_source_get_type(source)) {
+	case OBS_SOURCE_TYPE_INPUT: {
+		uint32_t flags = obs_source_get_output_flags(source);
+		categories     = category::SOURCE;
+		if (flags & OBS_SOURCE_VIDEO) {
+			categories = categories | category::VIDEO;
+		}
+		if (flags & OBS_SOURCE_AUDIO) {
+			categories = categories | category::AUDIO;
+		}
+		break;
+	}
+	case OBS_SOURCE_TYPE_TRANSITION:
+		categories = category::TRANSITION;
+		break;
+	case OBS_SOURCE_TYPE_SCENE:
+		categories = category::SCENE;
+		break;
+	default:
+		break;
+	}
+	return categories;
+}
+
 std::shared_ptr<streamfx::obs::source_tracker> streamfx::obs::source_tracker::get()
 {
 	static std::mutex                                   inst_mtx;
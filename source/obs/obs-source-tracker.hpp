@@ -21,15 +21,34 @@
 #include "common.hpp"
 
 #include "warning-disable.hpp"
+#include <atomic>
 #include <functional>
 #include <map>
 #include <mutex>
+#include <vector>
 #include "warning-enable.hpp"
 
 namespace streamfx::obs {
 	class source_tracker {
-		std::map<std::string, std::shared_ptr<obs_weak_source_t>> _sources;
-		std::mutex                                                _mutex;
+		public:
+		enum class category : uint8_t {
+			NONE       = 0,
+			SOURCE     = 1 << 0, // Inputs, matches filter_sources.
+			VIDEO      = 1 << 1, // Inputs with video, matches filter_video_sources.
+			AUDIO      = 1 << 2, // Inputs with audio, matches filter_audio_sources.
+			TRANSITION = 1 << 3, // Matches filter_transitions.
+			SCENE      = 1 << 4, // Matches filter_scenes.
+		};
+
+		typedef std::map<std::string, std::shared_ptr<obs_weak_source_t>> index_t;
+		typedef std::shared_ptr<const std::vector<std::string>>           names_t;
+
+		private:
+		std::map<std::string, std::pair<std::shared_ptr<obs_weak_source_t>, category>> _sources;
+		std::map<category, index_t>                                                    _indices;
+		std::map<category, std::pair<uint64_t, names_t>>                               _names;
+		std::atomic<uint64_t>                                                          _generation;
+		std::mutex                                                                     _mutex;
 
 		static void source_create_handler(void* ptr, calldata_t* data) noexcept;
 		static void source_destroy_handler(void* ptr, calldata_t* data) noexcept;
@@ -40,6 +59,10 @@ namespace streamfx::obs {
 		void remove_source(obs_source_t* source);
 		void rename_source(std::string_view old_name, std::string_view new_name, obs_source_t* source);
 
+		// Must be called with _mutex held. Sources without a category do not replace a live source of the same name.
+		void index_insert(const std::string& name, std::shared_ptr<obs_weak_source_t> weak, category categories);
+		void index_remove(const std::string& name);
+
 		public:
 		// Callback function for enumerating sources.
 		//
@@ -67,14 +90,38 @@ namespace streamfx::obs {
 		// @param filter_cb Filter function to narrow down results.
 		void enumerate(enumerate_cb_t enumerate_cb, filter_cb_t filter_cb = nullptr);
 
+		//! Enumerate all tracked sources of a single category
+		//
+		// Only walks the index for the category, instead of filtering every tracked source.
+		//
+		// @param enumerate_cb The function called for each tracked source.
+		// @param filter The category to enumerate.
+		void enumerate(enumerate_cb_t enumerate_cb, category filter);
+
+		//! Sorted names of all tracked sources of a single category
+		//
+		// The list is cached and only rebuilt after sources in the tracker changed.
+		//
+		// @param filter The category to list.
+		names_t names(category filter);
+
+		//! Generation of the tracked sources
+		//
+		// Incremented on every insertion, removal and rename, so that consumers can cache what they build from the
+		// tracked sources and only rebuild it if the generation changed.
+		uint64_t generation();
+
 		public:
 		static bool filter_sources(std::string name, obs_source_t* source);
 		static bool filter_audio_sources(std::string name, obs_source_t* source);
 		static bool filter_video_sources(std::string name, obs_source_t* source);
 		static bool filter_transitions(std::string name, obs_source_t* source);
 		static bool filter_scenes(std::string name, obs_source_t* source);
+		static category categorize(obs_source_t* source);
 
 		public: // Singleton
 		static std::shared_ptr<streamfx::obs::source_tracker> get();
 	};
 } // namespace streamfx::obs
+
+P_ENABLE_BITMASK_OPERATORS(streamfx::obs::source_tracker::category)
@@ -18,6 +18,7 @@
  */
 
 #include "obs-tools.hpp"
+#include "obs-source-graph.hpp"
 #include "obs-source.hpp"
 #include "obs-weak-source.hpp"
 #include "plugin.hpp"
@@ -97,6 +98,11 @@ void __source_find_source_enumerate(obs_source_t* haystack, __sfs_data* cbd)
 
 bool streamfx::obs::tools::source_find_source(::streamfx::obs::source haystack, ::streamfx::obs::source needle)
 {
+	// Prefer the maintained graph, which caches reachability until something changes.
+	if (auto graph = ::streamfx::obs::source_graph::instance(); graph) {
+		return graph->contains(haystack.get(), needle.get());
+	}
+
 	__sfs_data cbd = {};
 	try {
 		__source_find_source_enumerate(haystack.get(), &cbd);
@@ -55,4 +55,9 @@ namespace streamfx::obs {
 	{
 		obs_data_release(v);
 	}
+
+	inline void obs_data_array_deleter(obs_data_array_t* v)
+	{
+		obs_data_array_release(v);
+	}
 } // namespace streamfx::obs
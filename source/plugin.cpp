@@ -19,10 +19,15 @@
 
 #include "plugin.hpp"
 #include "configuration.hpp"
+#include "statistics.hpp"
 #include "gfx/gfx-opengl.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "obs/gs/gs-vertexbuffer.hpp"
+#include "obs/obs-frame-graph.hpp"
+#include "obs/obs-source-graph.hpp"
 #include "obs/obs-source-tracker.hpp"
+#include "util/util-logging.hpp"
 
 #ifdef ENABLE_NVIDIA_CUDA
 #include "nvidia/cuda/nvidia-cuda-obs.hpp"
@@ -33,6 +38,8 @@
 #endif
 #ifdef ENABLE_ENCODER_FFMPEG
 #include "encoders/encoder-ffmpeg.hpp"
+#include "ffmpeg/avframe-pool.hpp"
+#include "ffmpeg/conversion-cache.hpp"
 #endif
 
 #ifdef ENABLE_FILTER_AUTOFRAMING
@@ -94,10 +101,20 @@
 #include <stdexcept>
 #include "warning-enable.hpp"
 
+constexpr std::string_view _cfg_threadpool_statistics_interval = "ThreadPool.StatisticsInterval";
+constexpr std::string_view _cfg_statistics_interval            = "Statistics.Interval";
+constexpr std::string_view _cfg_logging_asynchronous           = "Logging.Asynchronous";
+
 static std::shared_ptr<streamfx::util::threadpool::threadpool> _threadpool;
 static std::shared_ptr<streamfx::gfx::opengl>                  _streamfx_gfx_opengl;
 static std::shared_ptr<streamfx::obs::source_tracker>          _source_tracker;
 
+static void logging_tick(void*, float)
+{
+	// Report repetitions of rate limited messages, even if they stopped occurring.
+	streamfx::util::logging::flush_limited();
+}
+
 MODULE_EXPORT bool obs_module_load(void)
 {
 	try {
@@ -105,13 +122,44 @@ MODULE_EXPORT bool obs_module_load(void)
 
 		// Initialize global configuration.
 		streamfx::configuration::initialize();
+		if (auto data = streamfx::configuration::instance()->get(); data) {
+			// Keep libOBS' log lock and file I/O off of the graphics and encoder threads. Disabled by default, as
+			// messages still queued are lost on a crash, and those tend to be the ones explaining it.
+			obs_data_set_default_bool(data.get(), _cfg_logging_asynchronous.data(), false);
+			streamfx::util::logging::set_asynchronous(obs_data_get_bool(data.get(), _cfg_logging_asynchronous.data()));
+		}
+		obs_add_tick_callback(logging_tick, nullptr);
 
 		// Initialize global Thread Pool.
 		_threadpool = std::make_shared<streamfx::util::threadpool::threadpool>();
+		if (auto data = streamfx::configuration::instance()->get(); data) {
+			// Periodically dump thread pool statistics to the log, disabled by default.
+			obs_data_set_default_int(data.get(), _cfg_threadpool_statistics_interval.data(), 0);
+			_threadpool->set_statistics_interval(std::chrono::seconds(
+				obs_data_get_int(data.get(), _cfg_threadpool_statistics_interval.data())));
+		}
+
+		// Initialize Statistics
+		streamfx::statistics::initialize();
+		if (auto data = streamfx::configuration::instance()->get(); data) {
+			// Periodically write instance statistics to the log, disabled by default.
+			obs_data_set_default_int(data.get(), _cfg_statistics_interval.data(), 0);
+			streamfx::statistics::instance()->set_interval(
+				std::chrono::seconds(obs_data_get_int(data.get(), _cfg_statistics_interval.data())));
+		}
 
 		// Initialize Source Tracker
 		_source_tracker = streamfx::obs::source_tracker::get();
 
+		// Initialize Source Graph
+		streamfx::obs::source_graph::initialize();
+
+		// Initialize Render Target Pool
+		streamfx::obs::gs::rendertarget_pool::initialize();
+
+		// Initialize Frame Graph
+		streamfx::obs::frame_graph::initialize();
+
 		// Initialize GLAD (OpenGL)
 		{
 			streamfx::obs::gs::context gctx{};
@@ -137,6 +185,8 @@ MODULE_EXPORT bool obs_module_load(void)
 #endif
 #ifdef ENABLE_ENCODER_FFMPEG
 			using namespace streamfx::encoder::ffmpeg;
+			streamfx::ffmpeg::avframe_pool::initialize();
+			streamfx::ffmpeg::conversion_cache::initialize();
 			ffmpeg_manager::initialize();
 #endif
 		}
@@ -279,6 +329,8 @@ MODULE_EXPORT void obs_module_unload(void)
 		{
 #ifdef ENABLE_ENCODER_FFMPEG
 			streamfx::encoder::ffmpeg::ffmpeg_manager::finalize();
+			streamfx::ffmpeg::conversion_cache::finalize();
+			streamfx::ffmpeg::avframe_pool::finalize();
 #endif
 #ifdef ENABLE_ENCODER_AOM_AV1
 			streamfx::encoder::aom::av1::aom_av1_factory::finalize();
@@ -291,9 +343,21 @@ MODULE_EXPORT void obs_module_unload(void)
 			_streamfx_gfx_opengl.reset();
 		}
 
+		// Finalize Frame Graph
+		streamfx::obs::frame_graph::finalize();
+
+		// Finalize Render Target Pool
+		streamfx::obs::gs::rendertarget_pool::finalize();
+
+		// Finalize Source Graph
+		streamfx::obs::source_graph::finalize();
+
 		// Finalize Source Tracker
 		_source_tracker.reset();
 
+		// Finalize Statistics
+		streamfx::statistics::finalize();
+
 		//	// Auto-Updater
 		//#ifdef ENABLE_UPDATER
 		//	_updater.reset();
@@ -305,6 +369,11 @@ MODULE_EXPORT void obs_module_unload(void)
 		// Finalize Thread Pool
 		_threadpool.reset();
 
+		// Flush any pending log messages.
+		obs_remove_tick_callback(logging_tick, nullptr);
+		streamfx::util::logging::flush_limited(true);
+		streamfx::util::logging::set_asynchronous(false);
+
 		DLOG_INFO("Unloaded Version %s", STREAMFX_VERSION_STRING);
 	} catch (std::exception const& ex) {
 		DLOG_ERROR("Unexpected exception in function '%s': %s", __FUNCTION_NAME__, ex.what());
@@ -277,7 +277,8 @@ void mirror_instance::on_audio(::streamfx::obs::source, const audio_data* audio,
 	}
 
 	// Create a clone of the audio data and push it to the thread pool.
-	streamfx::threadpool()->push(std::bind(&mirror_instance::audio_output, this, std::placeholders::_1), nullptr);
+	streamfx::threadpool()->push(std::bind(&mirror_instance::audio_output, this, std::placeholders::_1), nullptr,
+								 streamfx::util::threadpool::priority::REALTIME);
 }
 
 void mirror_instance::audio_output(std::shared_ptr<void> data)
@@ -347,22 +348,18 @@ obs_properties_t* mirror_factory::get_properties2(mirror_instance* data)
 		obs_property_set_modified_callback(p, modified_properties);
 
 		obs_property_list_add_string(p, "", "");
-		obs::source_tracker::get()->enumerate(
-			[&p](std::string name, obs_source_t*) {
-				std::stringstream sstr;
-				sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SOURCE) << ")";
-				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
-				return false;
-			},
-			obs::source_tracker::filter_sources);
-		obs::source_tracker::get()->enumerate(
-			[&p](std::string name, obs_source_t*) {
-				std::stringstream sstr;
-				sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SCENE) << ")";
-				obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
-				return false;
-			},
-			obs::source_tracker::filter_scenes);
+		auto sources = obs::source_tracker::get()->names(obs::source_tracker::category::SOURCE);
+		for (auto& name : *sources) {
+			std::stringstream sstr;
+			sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SOURCE) << ")";
+			obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
+		}
+		auto scenes = obs::source_tracker::get()->names(obs::source_tracker::category::SCENE);
+		for (auto& name : *scenes) {
+			std::stringstream sstr;
+			sstr << name << " (" << D_TRANSLATE(S_SOURCETYPE_SCENE) << ")";
+			obs_property_list_add_string(p, sstr.str().c_str(), name.c_str());
+		}
 	}
 
 	{
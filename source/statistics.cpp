@@ -0,0 +1,214 @@
+// Copyright (C) 2022 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#include "statistics.hpp"
+#include "plugin.hpp"
+#include "obs/obs-tools.hpp"
+#include "util/util-logging.hpp"
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<statistics> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+constexpr std::string_view proc_declaration = "void streamfx_statistics(out string json)";
+
+streamfx::statistics::~statistics()
+{
+	obs_remove_tick_callback(tick, this);
+
+	std::shared_ptr<streamfx::util::threadpool::task> task;
+	{
+		std::lock_guard<std::mutex> lg(_lock);
+		task = _log_task;
+	}
+	if (task) {
+		task->await_completion();
+	}
+}
+
+streamfx::statistics::statistics() : _lock(), _providers(), _interval(0), _elapsed(0), _log_task()
+{
+	obs_add_tick_callback(tick, this);
+}
+
+std::shared_ptr<void> streamfx::statistics::add(std::string_view category, provider_t provider)
+{
+	std::lock_guard<std::mutex> lg(_lock);
+	auto itr = _providers.emplace(_providers.end(), std::string{category}, provider);
+
+	// The handle only holds a weak reference, so that instances may outlive the statistics system.
+	std::weak_ptr<streamfx::statistics> self = instance();
+	return std::shared_ptr<void>(nullptr, [self, itr](void*) {
+		if (auto strong = self.lock(); strong) {
+			std::lock_guard<std::mutex> lg(strong->_lock);
+			strong->_providers.erase(itr);
+		}
+	});
+}
+
+std::shared_ptr<obs_data_t> streamfx::statistics::collect()
+{
+	std::shared_ptr<obs_data_t> root{obs_data_create(), streamfx::obs::obs_data_deleter};
+	std::map<std::string, std::shared_ptr<obs_data_array_t>> categories;
+
+	{ // Thread Pool
+		static constexpr std::string_view lane_names[] = {"realtime", "normal", "background"};
+
+		std::shared_ptr<obs_data_array_t> lanes{obs_data_array_create(), streamfx::obs::obs_data_array_deleter};
+		auto                              stats = streamfx::threadpool()->statistics();
+		for (size_t idx = 0; idx < stats.size(); idx++) {
+			std::shared_ptr<obs_data_t> lane{obs_data_create(), streamfx::obs::obs_data_deleter};
+			obs_data_set_string(lane.get(), "name", lane_names[idx].data());
+			obs_data_set_int(lane.get(), "workers", static_cast<long long>(stats[idx].workers));
+			obs_data_set_int(lane.get(), "busy_workers", static_cast<long long>(stats[idx].busy_workers));
+			obs_data_set_int(lane.get(), "queued", static_cast<long long>(stats[idx].queued));
+			obs_data_set_int(lane.get(), "queued_peak", static_cast<long long>(stats[idx].queued_peak));
+			obs_data_set_int(lane.get(), "executed", static_cast<long long>(stats[idx].executed));
+			obs_data_set_int(
+				lane.get(), "wait_p99_us",
+				static_cast<long long>(streamfx::util::threadpool::histogram_percentile(stats[idx].wait_time, .99).count()));
+			obs_data_set_int(
+				lane.get(), "run_p99_us",
+				static_cast<long long>(streamfx::util::threadpool::histogram_percentile(stats[idx].run_time, .99).count()));
+			obs_data_array_push_back(lanes.get(), lane.get());
+		}
+		obs_data_set_array(root.get(), "threadpool", lanes.get());
+	}
+
+	{ // Registered Providers
+		std::lock_guard<std::mutex> lg(_lock);
+		for (auto& kv : _providers) {
+			auto& array = categories[kv.first];
+			if (!array) {
+				array = {obs_data_array_create(), streamfx::obs::obs_data_array_deleter};
+			}
+
+			std::shared_ptr<obs_data_t> entry{obs_data_create(), streamfx::obs::obs_data_deleter};
+			try {
+				kv.second(entry.get());
+			} catch (const std::exception& ex) {
+				obs_data_set_string(entry.get(), "error", ex.what());
+			}
+			obs_data_array_push_back(array.get(), entry.get());
+		}
+	}
+	for (auto& kv : categories) {
+		obs_data_set_array(root.get(), kv.first.c_str(), kv.second.get());
+	}
+
+	return root;
+}
+
+void streamfx::statistics::log()
+{
+	auto data = collect();
+	D_LOG_INFO("%s", obs_data_get_json(data.get()));
+}
+
+void streamfx::statistics::set_interval(std::chrono::seconds interval)
+{
+	std::lock_guard<std::mutex> lg(_lock);
+	_interval = std::max(interval, std::chrono::seconds(0));
+	_elapsed  = 0;
+}
+
+void streamfx::statistics::write_profiler(obs_data_t* data, std::string_view name,
+										  std::shared_ptr<streamfx::util::profiler> profiler)
+{
+	if (!profiler || (profiler->count() == 0)) {
+		return;
+	}
+
+	std::shared_ptr<obs_data_t> entry{obs_data_create(), streamfx::obs::obs_data_deleter};
+	obs_data_set_int(entry.get(), "count", static_cast<long long>(profiler->count()));
+	obs_data_set_double(entry.get(), "average_us", profiler->average_duration() / 1000.);
+	obs_data_set_double(entry.get(), "p50_us", static_cast<double>(profiler->percentile(0.500).count()) / 1000.);
+	obs_data_set_double(entry.get(), "p95_us", static_cast<double>(profiler->percentile(0.950).count()) / 1000.);
+	obs_data_set_double(entry.get(), "p99_us", static_cast<double>(profiler->percentile(0.990).count()) / 1000.);
+	obs_data_set_double(entry.get(), "p999_us", static_cast<double>(profiler->percentile(0.999).count()) / 1000.);
+	obs_data_set_obj(data, name.data(), entry.get());
+}
+
+void streamfx::statistics::proc_statistics(void*, calldata_t* cd)
+{
+	try {
+		if (auto self = instance(); self) {
+			auto data = self->collect();
+			calldata_set_string(cd, "json", obs_data_get_json(data.get()));
+		}
+	} catch (const std::exception& ex) {
+		D_LOG_ERROR("Failed to collect statistics: %s", ex.what());
+	} catch (...) {
+		D_LOG_ERROR("Failed to collect statistics.", nullptr);
+	}
+}
+
+void streamfx::statistics::tick(void* data, float seconds)
+{
+	auto self = reinterpret_cast<streamfx::statistics*>(data);
+
+	std::lock_guard<std::mutex> lg(self->_lock);
+	if (self->_interval.count() <= 0) {
+		return;
+	}
+
+	self->_elapsed += seconds;
+	if ((self->_elapsed < static_cast<float>(self->_interval.count()))
+		|| (self->_log_task && !self->_log_task->is_completed())) {
+		return;
+	}
+	self->_elapsed = 0;
+
+	// Collecting queries every instance, so keep it off the graphics thread.
+	self->_log_task = streamfx::threadpool()->push([self](streamfx::util::threadpool::task_data_t) { self->log(); },
+												   nullptr, streamfx::util::threadpool::priority::BACKGROUND);
+}
+
+static std::shared_ptr<streamfx::statistics> _instance = nullptr;
+
+void streamfx::statistics::initialize()
+{
+	if (!_instance) {
+		_instance = std::make_shared<streamfx::statistics>();
+
+		// The proc handler does not support removal, so this is only ever added once.
+		static bool registered = false;
+		if (!registered) {
+			proc_handler_add(obs_get_proc_handler(), proc_declaration.data(), proc_statistics, nullptr);
+			registered = true;
+		}
+	}
+}
+
+void streamfx::statistics::finalize()
+{
+	_instance.reset();
+}
+
+std::shared_ptr<streamfx::statistics> streamfx::statistics::instance()
+{
+	return _instance;
+}
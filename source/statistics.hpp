@@ -0,0 +1,84 @@
+// Copyright (C) 2022 Michael Fabian Dirks
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+
+#pragma once
+#include "common.hpp"
+
+#include "warning-disable.hpp"
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include "warning-enable.hpp"
+
+namespace streamfx {
+	/** Live statistics of every StreamFX source, filter, transition and encoder instance.
+	 *
+	 * Instances register a provider, which fills in a structured description of their current state. The collected
+	 * result is available to external tooling through the 'streamfx_statistics' procedure on the global proc handler,
+	 * and can optionally be written to the log periodically.
+	 */
+	class statistics {
+		public:
+		typedef std::function<void(obs_data_t*)> provider_t;
+
+		private:
+		std::mutex                                        _lock;
+		std::list<std::pair<std::string, provider_t>>     _providers;
+		std::chrono::seconds                              _interval;
+		float                                             _elapsed;
+		std::shared_ptr<streamfx::util::threadpool::task> _log_task;
+
+		public:
+		~statistics();
+		statistics();
+
+		public:
+		/** Register a provider for the given category.
+		 *
+		 * @return Handle that keeps the provider registered, releasing it unregisters the provider.
+		 */
+		std::shared_ptr<void> add(std::string_view category, provider_t provider);
+
+		/** Collect the current state of all registered providers.
+		 */
+		std::shared_ptr<obs_data_t> collect();
+
+		/** Write the current state of all registered providers to the log as a single JSON line.
+		 */
+		void log();
+
+		/** Log statistics every interval, or never if zero.
+		 */
+		void set_interval(std::chrono::seconds interval);
+
+		public:
+		/** Describe a profiler as count, average and percentiles in microseconds.
+		 */
+		static void write_profiler(obs_data_t* data, std::string_view name,
+								   std::shared_ptr<streamfx::util::profiler> profiler);
+
+		private:
+		static void proc_statistics(void* data, calldata_t* cd);
+
+		static void tick(void* data, float seconds);
+
+		public /* Singleton */:
+		static void                                  initialize();
+		static void                                  finalize();
+		static std::shared_ptr<streamfx::statistics> instance();
+	};
+} // namespace streamfx
@@ -24,7 +24,13 @@
 #include "obs/obs-tools.hpp"
 #include "plugin.hpp"
 
+#ifdef ENABLE_PROFILING
+#include "util/util-trace.hpp"
+#endif
+
 #include "warning-disable.hpp"
+#include <chrono>
+#include <ctime>
 #include <string_view>
 #include "warning-enable.hpp"
 
@@ -39,6 +45,7 @@ constexpr std::string_view _i18n_menu_youtube = "UI.Menu.YouTube";
 constexpr std::string_view _i18n_menu_twitter = "UI.Menu.Twitter";
 constexpr std::string_view _i18n_menu_github  = "UI.Menu.Github";
 constexpr std::string_view _i18n_menu_about   = "UI.Menu.About";
+constexpr std::string_view _i18n_menu_trace   = "UI.Menu.Trace";
 
 // Configuration
 constexpr std::string_view _cfg_have_shown_about = "UI.HaveShownAboutStreamFX";
@@ -81,6 +88,10 @@ streamfx::ui::handler::handler()
 
 	  _action_support(), _action_wiki(), _action_website(), _action_discord(), _action_twitter(), _action_youtube(),
 
+#ifdef ENABLE_PROFILING
+	  _action_trace(),
+#endif
+
 	  _about_action(), _about_dialog(),
 
 	  _translator()
@@ -136,6 +147,8 @@ void streamfx::ui::handler::on_obs_loaded()
 		// YouTube
 		// <--->
 		// <Updater>
+		// <--->
+		// <Save Trace>
 		// ---
 		// About StreamFX
 
@@ -175,6 +188,15 @@ void streamfx::ui::handler::on_obs_loaded()
 		_updater = streamfx::ui::updater::instance(_menu);
 #endif
 
+#ifdef ENABLE_PROFILING
+		_menu->addSeparator();
+		{
+			_action_trace = _menu->addAction(QString::fromUtf8(D_TRANSLATE(_i18n_menu_trace.data())));
+			_action_trace->setMenuRole(QAction::NoRole);
+			connect(_action_trace, &QAction::triggered, this, &streamfx::ui::handler::on_action_trace);
+		}
+#endif
+
 		_menu->addSeparator();
 
 		// About
@@ -252,6 +274,18 @@ void streamfx::ui::handler::on_action_youtube(bool)
 	QDesktopServices::openUrl(QUrl(QString::fromUtf8(_url_youtube.data())));
 }
 
+#ifdef ENABLE_PROFILING
+void streamfx::ui::handler::on_action_trace(bool)
+{
+	// Name the file after the current time, so that multiple traces can be compared.
+	auto    now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	std::tm tm  = *std::localtime(&now);
+	char    name[64];
+	std::strftime(name, sizeof(name), "trace-%Y%m%d-%H%M%S.json", &tm);
+	streamfx::util::trace::dump(streamfx::config_file_path(name));
+}
+#endif
+
 void streamfx::ui::handler::on_action_about(bool checked)
 {
 	_about_dialog->show();
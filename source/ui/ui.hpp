@@ -41,6 +41,10 @@ namespace streamfx::ui {
 		QAction* _action_twitter;
 		QAction* _action_youtube;
 
+#ifdef ENABLE_PROFILING
+		QAction* _action_trace;
+#endif
+
 		// About Dialog
 		QAction*   _about_action;
 		ui::about* _about_dialog;
@@ -74,6 +78,10 @@ namespace streamfx::ui {
 		void on_action_twitter(bool);
 		void on_action_youtube(bool);
 
+#ifdef ENABLE_PROFILING
+		void on_action_trace(bool);
+#endif
+
 		// About
 		void on_action_about(bool);
 
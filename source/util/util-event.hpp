@@ -21,26 +21,69 @@
 #include "common.hpp"
 
 #include "warning-disable.hpp"
+#include <algorithm>
+#include <atomic>
 #include <functional>
-#include <list>
+#include <memory>
 #include <mutex>
+#include <vector>
 #include "warning-enable.hpp"
 
 namespace streamfx::util {
+	/** Multicast event with lock-free dispatch.
+	 *
+	 * Listeners are stored in an immutable snapshot which is replaced as a whole on every change, so calling the event
+	 * only needs an atomic load. Replaced snapshots are kept alive with a two-epoch scheme: callers register in the
+	 * current epoch, and a snapshot retired in epoch E is freed once the epoch reached E + 2, as that requires all
+	 * callers of epoch E to have left. Changes never wait for callers, so listeners may still modify the event.
+	 */
 	template<typename... _args>
 	class event {
-		std::list<std::function<void(_args...)>> _listeners;
-		std::recursive_mutex                     _lock;
+		typedef std::vector<std::function<void(_args...)>> listeners_t;
+
+		std::atomic<listeners_t*> _listeners;
+		std::atomic<size_t>       _epoch;
+		std::atomic<size_t>       _callers[2];
+
+		std::recursive_mutex                        _lock;
+		std::vector<std::pair<size_t, listeners_t*>> _retired;
 
 		std::function<void()> _cb_fill;
 		std::function<void()> _cb_clear;
 
+		class caller {
+			std::atomic<size_t>& _counter;
+
+			static std::atomic<size_t>& enter(event<_args...>* self)
+			{
+				while (true) {
+					size_t epoch   = self->_epoch.load();
+					auto&  counter = self->_callers[epoch & 1];
+					counter.fetch_add(1);
+					if (self->_epoch.load() == epoch) {
+						return counter;
+					}
+					counter.fetch_sub(1);
+				}
+			}
+
+			public:
+			caller(event<_args...>* self) : _counter(enter(self)) {}
+			~caller()
+			{
+				_counter.fetch_sub(1);
+			}
+		};
+
 		public /* constructor */:
-		event() : _listeners(), _lock(), _cb_fill(), _cb_clear() {}
+		event() : _listeners(nullptr), _epoch(0), _callers{0, 0}, _lock(), _retired(), _cb_fill(), _cb_clear() {}
 		virtual ~event()
 		{
 			std::lock_guard<std::recursive_mutex> lg(_lock);
 			this->clear();
+			for (auto& kv : _retired) {
+				delete kv.second;
+			}
 		}
 
 		/* Copy Constructor */
@@ -49,12 +92,7 @@ namespace streamfx::util {
 		/* Move Constructor */
 		event(event<_args...>&& other) noexcept : event()
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
-			std::lock_guard<std::recursive_mutex> lgo(other._lock);
-
-			_listeners.swap(other._listeners);
-			_cb_fill.swap(other._cb_fill);
-			_cb_clear.swap(other._cb_clear);
+			*this = std::move(other);
 		}
 
 		public /* operators */:
@@ -68,7 +106,7 @@ namespace streamfx::util {
 			std::lock_guard<std::recursive_mutex> lg(_lock);
 			std::lock_guard<std::recursive_mutex> lgo(other._lock);
 
-			_listeners.swap(other._listeners);
+			_listeners.store(other._listeners.exchange(_listeners.load()));
 			_cb_fill.swap(other._cb_fill);
 			_cb_clear.swap(other._cb_clear);
 
@@ -85,9 +123,11 @@ namespace streamfx::util {
 		template<typename... _largs>
 		inline void call(_args... args)
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
-			for (auto& l : _listeners) {
-				l(args...);
+			caller guard(this);
+			if (auto listeners = _listeners.load(); listeners) {
+				for (auto& l : *listeners) {
+					l(args...);
+				}
 			}
 		}
 
@@ -99,12 +139,16 @@ namespace streamfx::util {
 		inline void add(std::function<void(_args...)> listener)
 		{
 			std::lock_guard<std::recursive_mutex> lg(_lock);
-			if (_listeners.size() == 0) {
+			auto                                  current = _listeners.load();
+			if (!current || current->empty()) {
 				if (_cb_fill) {
 					_cb_fill();
 				}
 			}
-			_listeners.push_back(listener);
+
+			auto listeners = current ? new listeners_t(*current) : new listeners_t();
+			listeners->push_back(listener);
+			replace(listeners);
 		}
 		inline event<_args...>& operator+=(std::function<void(_args...)> listener)
 		{
@@ -118,8 +162,15 @@ namespace streamfx::util {
 		inline void remove(std::function<void(_args...)> listener)
 		{
 			std::lock_guard<std::recursive_mutex> lg(_lock);
-			_listeners.remove(listener);
-			if (_listeners.size() == 0) {
+			auto                                  current = _listeners.load();
+			if (!current) {
+				return;
+			}
+
+			auto listeners = new listeners_t(*current);
+			listeners->erase(std::remove(listeners->begin(), listeners->end(), listener), listeners->end());
+			replace(listeners);
+			if (listeners->size() == 0) {
 				if (_cb_clear) {
 					_cb_clear();
 				}
@@ -136,8 +187,9 @@ namespace streamfx::util {
 		 */
 		inline bool empty()
 		{
-			std::lock_guard<std::recursive_mutex> lg(_lock);
-			return _listeners.empty();
+			caller guard(this);
+			auto   listeners = _listeners.load();
+			return !listeners || listeners->empty();
 		}
 		inline operator bool()
 		{
@@ -149,7 +201,7 @@ namespace streamfx::util {
 		inline void clear()
 		{
 			std::lock_guard<std::recursive_mutex> lg(_lock);
-			_listeners.clear();
+			replace(nullptr);
 			if (_cb_clear) {
 				_cb_clear();
 			}
@@ -173,5 +225,42 @@ namespace streamfx::util {
 			std::lock_guard<std::recursive_mutex> lg(_lock);
 			this->_cb_clear = cb;
 		}
+
+		private:
+		// All of these must be called with _lock held.
+		void replace(listeners_t* listeners)
+		{
+			retire(_listeners.exchange(listeners));
+			reclaim();
+		}
+
+		void retire(listeners_t* listeners)
+		{
+			if (listeners) {
+				_retired.emplace_back(_epoch.load(), listeners);
+			}
+		}
+
+		void reclaim()
+		{
+			// Advance the epoch as far as possible, which is at most twice as only two epochs can have callers.
+			for (size_t idx = 0; idx < 2; idx++) {
+				size_t epoch = _epoch.load();
+				if (_callers[(epoch + 1) & 1].load() != 0) {
+					break;
+				}
+				_epoch.store(epoch + 1);
+			}
+
+			size_t epoch = _epoch.load();
+			for (auto iter = _retired.begin(); iter != _retired.end();) {
+				if ((iter->first + 2) <= epoch) {
+					delete iter->second;
+					iter = _retired.erase(iter);
+				} else {
+					iter++;
+				}
+			}
+		}
 	};
 } // namespace streamfx::util
@@ -21,30 +21,380 @@
 #include "common.hpp"
 
 #include "warning-disable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
 #include <stdarg.h>
+#include <thread>
+#include <vector>
 #include "warning-enable.hpp"
 
-void streamfx::util::logging::log(level lvl, const char* format, ...)
+// Messages are formatted on the calling thread, as arguments like '%s' may point at temporaries, but handing them to
+// libOBS (which takes a global lock and writes to disk) is deferred to a background thread. The queue is a bounded
+// multi-producer ring, so logging never allocates or blocks on another thread. Messages which do not fit into a slot,
+// or arrive while the ring is full, are forwarded synchronously instead of being dropped, but only once everything
+// queued before them was written, so that the log stays in order.
+
+static constexpr size_t queue_size     = 256; // Must be a power of two.
+static constexpr size_t message_length = 496;
+
+struct queue_slot {
+	std::atomic<size_t> sequence;
+	int32_t             level;
+	char                text[message_length];
+};
+
+static queue_slot              _queue[queue_size];
+static std::atomic<size_t>     _queue_write;
+static std::atomic<size_t>     _queue_read;
+static std::atomic<bool>       _asynchronous;
+static std::atomic<size_t>     _writers;
+static std::atomic<bool>       _stop;
+static std::atomic<bool>       _sleeping;
+static std::mutex              _lock;
+static std::condition_variable _signal;
+static std::thread             _worker;
+
+static int32_t to_obs_level(streamfx::util::logging::level lvl)
+{
+	switch (lvl) {
+	case streamfx::util::logging::level::LEVEL_DEBUG:
+		return LOG_DEBUG;
+	case streamfx::util::logging::level::LEVEL_INFO:
+		return LOG_INFO;
+	case streamfx::util::logging::level::LEVEL_WARN:
+		return LOG_WARNING;
+	default:
+		return LOG_ERROR;
+	}
+}
+
+static void log_synchronous(int32_t level, const char* format, va_list vargs)
 {
-	const static std::map<level, int32_t> level_map = {
-		{level::LEVEL_DEBUG, LOG_DEBUG},
-		{level::LEVEL_INFO, LOG_INFO},
-		{level::LEVEL_WARN, LOG_WARNING},
-		{level::LEVEL_ERROR, LOG_ERROR},
-	};
 	thread_local static std::vector<char> buffer;
 
+	char    local[1024];
+	va_list vargs_copy;
+	va_copy(vargs_copy, vargs);
+	int32_t ret = vsnprintf(local, sizeof(local), format, vargs_copy);
+	va_end(vargs_copy);
+
+	if (ret < 0) {
+		return;
+	} else if (static_cast<size_t>(ret) < sizeof(local)) {
+		blog(level, "[StreamFX] %s", local);
+	} else {
+		buffer.resize(static_cast<size_t>(ret) + 1);
+		vsnprintf(buffer.data(), buffer.size(), format, vargs);
+		blog(level, "[StreamFX] %s", buffer.data());
+	}
+}
+
+static queue_slot* queue_reserve()
+{
+	size_t position = _queue_write.load(std::memory_order_relaxed);
+	while (true) {
+		queue_slot& slot     = _queue[position & (queue_size - 1)];
+		size_t      sequence = slot.sequence.load(std::memory_order_acquire);
+		if (sequence == position) {
+			if (_queue_write.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				return &slot;
+			}
+		} else if (sequence < position) {
+			return nullptr; // Full, the reader has not released this slot yet.
+		} else {
+			position = _queue_write.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+static void queue_publish(queue_slot* slot)
+{
+	// The slot was reserved at 'sequence', publishing advances it by one so the reader picks it up.
+	slot->sequence.store(slot->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_sleeping.load()) {
+		// Taking the lock orders this against the reader going to sleep, so the wake-up can't be lost.
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+		}
+		_signal.notify_one();
+	}
+}
+
+static bool queue_ready()
+{
+	size_t position = _queue_read.load(std::memory_order_relaxed);
+	return _queue[position & (queue_size - 1)].sequence.load(std::memory_order_acquire) == (position + 1);
+}
+
+static void queue_drain(size_t position)
+{
+	// Only called by registered writers, so the worker can't stop before it got here.
+	while (_queue_read.load(std::memory_order_acquire) < position) {
+		std::this_thread::yield();
+	}
+}
+
+static void queue_worker()
+{
+	while (true) {
+		if (queue_ready()) {
+			size_t      position = _queue_read.load(std::memory_order_relaxed);
+			queue_slot& slot     = _queue[position & (queue_size - 1)];
+			if (slot.level >= 0) {
+				blog(slot.level, "[StreamFX] %s", slot.text);
+			}
+			slot.sequence.store(position + queue_size, std::memory_order_release);
+			_queue_read.store(position + 1, std::memory_order_release);
+			continue;
+		}
+
+		if (_stop.load()) {
+			break;
+		}
+
+		std::unique_lock<std::mutex> lock(_lock);
+		_sleeping.store(true);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		_signal.wait(lock, [] { return queue_ready() || _stop.load(); });
+		_sleeping.store(false);
+	}
+}
+
+static void log_va(streamfx::util::logging::level lvl, const char* format, va_list vargs)
+{
+	int32_t obs_level = to_obs_level(lvl);
+
+	// Register as a writer before checking the mode, so that set_asynchronous(false) can wait for us.
+	_writers.fetch_add(1);
+	if (_asynchronous.load()) {
+		if (queue_slot* slot = queue_reserve(); slot) {
+			va_list vargs_copy;
+			va_copy(vargs_copy, vargs);
+			int32_t ret = vsnprintf(slot->text, sizeof(slot->text), format, vargs_copy);
+			va_end(vargs_copy);
+
+			if ((ret >= 0) && (static_cast<size_t>(ret) < sizeof(slot->text))) {
+				slot->level = obs_level;
+				queue_publish(slot);
+				_writers.fetch_sub(1);
+				return;
+			}
+
+			// Too long for a slot, release it empty and fall back to the synchronous path.
+			size_t position = slot->sequence.load(std::memory_order_relaxed);
+			slot->level     = -1;
+			queue_publish(slot);
+			queue_drain(position + 1);
+		} else {
+			// Full, wait for everything queued so far instead of overtaking it.
+			queue_drain(_queue_write.load(std::memory_order_relaxed));
+		}
+	}
+	_writers.fetch_sub(1);
+
+	log_synchronous(obs_level, format, vargs);
+}
+
+void streamfx::util::logging::log(level lvl, const char* format, ...)
+{
 	va_list vargs;
 	va_start(vargs, format);
+	log_va(lvl, format, vargs);
+	va_end(vargs);
+}
 
+void streamfx::util::logging::set_asynchronous(bool enable)
+{
+	static std::mutex           state_lock;
+	std::lock_guard<std::mutex> lock(state_lock);
+
+	if (enable == _asynchronous.load()) {
+		return;
+	}
+
+	if (enable) {
+		for (size_t idx = 0; idx < queue_size; idx++) {
+			_queue[idx].sequence.store(idx, std::memory_order_relaxed);
+		}
+		_queue_write.store(0, std::memory_order_relaxed);
+		_queue_read.store(0, std::memory_order_relaxed);
+		_stop.store(false);
+		_worker = std::thread(queue_worker);
+		_asynchronous.store(true);
+	} else {
+		// Stop accepting new messages, wait for writers already in the queue, then drain it.
+		_asynchronous.store(false);
+		while (_writers.load() > 0) {
+			std::this_thread::yield();
+		}
+		{
+			std::lock_guard<std::mutex> lock2(_lock);
+			_stop.store(true);
+		}
+		_signal.notify_one();
+		_worker.join();
+	}
+}
+
+// Every limiter registers itself, so that flush_limited() can report messages of sites that went quiet.
+struct limiter_registry {
+	std::mutex                                     lock;
+	std::vector<streamfx::util::logging::limiter*> limiters;
+};
+
+static std::atomic<size_t>  _limited_pending; // Tracked messages with suppressed repetitions.
+static std::atomic<int64_t> _limited_next_flush;
+
+static limiter_registry& get_limiter_registry()
+{
+	static limiter_registry registry;
+	return registry;
+}
+
+static int64_t get_time()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+static uint64_t hash_message(streamfx::util::logging::level lvl, const char* text)
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull ^ static_cast<uint64_t>(lvl);
+	for (; *text != '\0'; text++) {
+		hash = (hash ^ static_cast<uint8_t>(*text)) * 1099511628211ull;
+	}
+	return hash;
+}
+
+void streamfx::util::logging::flush_limited(bool force /*= false*/)
+{
+	// Called periodically, so skip the work if there is nothing to report or it was checked recently.
+	if (_limited_pending.load(std::memory_order_relaxed) == 0) {
+		return;
+	}
+	int64_t now  = get_time();
+	int64_t next = _limited_next_flush.load(std::memory_order_relaxed);
+	if (!force && ((now < next) || !_limited_next_flush.compare_exchange_strong(next, now + 1'000'000'000))) {
+		return;
+	}
+
+	auto&                       registry = get_limiter_registry();
+	std::lock_guard<std::mutex> lock(registry.lock);
+	for (auto limiter : registry.limiters) {
+		limiter->flush(now, force);
+	}
+}
+
+streamfx::util::logging::limiter::~limiter()
+{
+	auto&                       registry = get_limiter_registry();
+	std::lock_guard<std::mutex> lock(registry.lock);
+	registry.limiters.erase(std::find(registry.limiters.begin(), registry.limiters.end(), this));
+}
+
+streamfx::util::logging::limiter::limiter() : _lock(), _entries()
+{
+	for (auto& message : _entries) {
+		message.hash       = 0;
+		message.lvl        = level::LEVEL_DEBUG;
+		message.next       = 0;
+		message.since      = 0;
+		message.suppressed = 0;
+	}
+
+	auto&                       registry = get_limiter_registry();
+	std::lock_guard<std::mutex> lock(registry.lock);
+	registry.limiters.push_back(this);
+}
+
+void streamfx::util::logging::limiter::log(level lvl, const char* format, ...)
+{
+	int64_t now = get_time();
+
+	va_list vargs;
+	va_start(vargs, format);
+
+	// Messages are told apart by their text, so it has to be formatted even if it ends up suppressed.
+	char    text[512];
 	va_list vargs_copy;
 	va_copy(vargs_copy, vargs);
-	int32_t ret = vsnprintf(buffer.data(), buffer.size(), format, vargs);
-	buffer.resize(static_cast<size_t>(ret) + 1);
-	ret = vsnprintf(buffer.data(), buffer.size(), format, vargs_copy);
+	int32_t ret = vsnprintf(text, sizeof(text), format, vargs_copy);
+	va_end(vargs_copy);
+	if (ret < 0) {
+		va_end(vargs);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
 
+		// Find the message, or replace the one that was let through the longest time ago.
+		uint64_t hash    = hash_message(lvl, text);
+		entry*   message = nullptr;
+		entry*   oldest  = &_entries[0];
+		for (auto& candidate : _entries) {
+			if ((candidate.next != 0) && (candidate.hash == hash) && (candidate.lvl == lvl)) {
+				message = &candidate;
+				break;
+			} else if (candidate.next < oldest->next) {
+				oldest = &candidate;
+			}
+		}
+		if (!message) {
+			summarize(*oldest, now);
+			message       = oldest;
+			message->hash = hash;
+			message->lvl  = lvl;
+			message->next = 0;
+		}
+
+		// Generic cell rate algorithm, a token bucket that only needs a single timestamp.
+		if (now < (message->next - (burst - 1) * interval)) {
+			if (message->suppressed++ == 0) {
+				message->since = now;
+				message->text  = text;
+				_limited_pending.fetch_add(1, std::memory_order_relaxed);
+			}
+			va_end(vargs);
+			return;
+		}
+		message->next = std::max(message->next, now) + interval;
+
+		// Report earlier repetitions before the message itself.
+		summarize(*message, now);
+	}
+
+	log_va(lvl, format, vargs);
 	va_end(vargs);
-	va_end(vargs_copy);
+}
+
+void streamfx::util::logging::limiter::flush(int64_t now, bool force)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	for (auto& message : _entries) {
+		if (force || (now >= (message.since + interval))) {
+			summarize(message, now);
+		}
+	}
+}
+
+void streamfx::util::logging::limiter::summarize(entry& message, int64_t now)
+{
+	if (message.suppressed == 0) {
+		return;
+	}
 
-	blog(level_map.at(lvl), "[StreamFX] %s", buffer.data());
+	streamfx::util::logging::log(message.lvl, "Suppressed %llu repetitions in the last %lld seconds of: %s",
+								 static_cast<unsigned long long>(message.suppressed),
+								 static_cast<long long>((now - message.since + 500'000'000) / 1'000'000'000),
+								 message.text.c_str());
+	message.suppressed = 0;
+	_limited_pending.fetch_sub(1, std::memory_order_relaxed);
 }
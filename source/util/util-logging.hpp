@@ -19,8 +19,12 @@
 
 #pragma once
 #include "warning-disable.hpp"
+#include <array>
+#include <atomic>
 #include <cinttypes>
 #include <cstdint>
+#include <mutex>
+#include <string>
 #include "warning-enable.hpp"
 
 #define P_LOG(...) streamfx::util::logging::log(__VA_ARGS__);
@@ -33,6 +37,16 @@
 #define P_LOG_DEBUG(...)
 #endif
 
+// Rate limited logging, for error paths which may be hit on every frame. Each use site gets its own limiter.
+#define P_LOG_LIMITED(lvl, ...)                                 \
+	do {                                                        \
+		static ::streamfx::util::logging::limiter _log_limiter; \
+		_log_limiter.log(lvl, __VA_ARGS__);                     \
+	} while (0)
+#define P_LOG_ERROR_LIMITED(...) P_LOG_LIMITED(streamfx::util::logging::level::LEVEL_ERROR, __VA_ARGS__)
+#define P_LOG_WARN_LIMITED(...) P_LOG_LIMITED(streamfx::util::logging::level::LEVEL_WARN, __VA_ARGS__)
+#define P_LOG_INFO_LIMITED(...) P_LOG_LIMITED(streamfx::util::logging::level::LEVEL_INFO, __VA_ARGS__)
+
 // Function/Class/Struct Name
 #ifdef _MSC_VER
 // Microsoft Visual Studio
@@ -57,4 +71,58 @@ namespace streamfx::util::logging {
 	};
 
 	void log(level lvl, const char* format, ...);
+
+	/** Forward messages to libOBS from a background thread instead of the calling one.
+	 *
+	 * Messages that can't be queued wait for all earlier messages before they are written. Disabling flushes all
+	 * pending messages before returning. Pending messages are lost if the process crashes.
+	 */
+	void set_asynchronous(bool enable);
+
+	/** Log summaries of messages suppressed by a limiter, once their interval is over.
+	 *
+	 * Called periodically, so that repetitions are reported even if a message stops occurring.
+	 *
+	 * @param force Log all summaries right away, regardless of their interval.
+	 */
+	void flush_limited(bool force = false);
+
+	/** Token bucket limiter for a single log site.
+	 *
+	 * Identical messages are allowed in a short burst, then once every interval. Messages are told apart by their
+	 * level and formatted text, so a site that logs varying text does not suppress one message with another. Once the
+	 * interval is over, the number of suppressed repetitions is logged by the next identical message, or by
+	 * flush_limited() if there is none.
+	 */
+	class limiter {
+		static constexpr int64_t burst    = 5;
+		static constexpr int64_t interval = 10'000'000'000; // Nanoseconds.
+		static constexpr size_t  tracked  = 4;              // Distinct messages tracked per site.
+
+		struct entry {
+			uint64_t    hash;
+			level       lvl;
+			int64_t     next;
+			int64_t     since;
+			uint64_t    suppressed;
+			std::string text;
+		};
+
+		std::mutex                 _lock;
+		std::array<entry, tracked> _entries;
+
+		public:
+		~limiter();
+		limiter();
+
+		public:
+		/** Log a message, unless an identical one was logged too often recently. */
+		void log(level lvl, const char* format, ...);
+
+		/** Log summaries of suppressed messages whose interval is over, or of all if forced. */
+		void flush(int64_t now, bool force);
+
+		private:
+		void summarize(entry& message, int64_t now);
+	};
 } // namespace streamfx::util::logging
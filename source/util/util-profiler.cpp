@@ -19,11 +19,22 @@
 
 #include "util-profiler.hpp"
 
+#ifdef ENABLE_PROFILING
+#include "util-trace.hpp"
+#endif
+
 #include "warning-disable.hpp"
-#include <iterator>
+#include <algorithm>
+#include <limits>
 #include "warning-enable.hpp"
 
-streamfx::util::profiler::profiler() {}
+streamfx::util::profiler::profiler(std::string_view name)
+	: _buckets(), _count(0), _total(0), _minimum(std::numeric_limits<uint64_t>::max()), _maximum(0), _name(name)
+{
+	for (auto& bucket : _buckets) {
+		bucket = 0;
+	}
+}
 
 streamfx::util::profiler::~profiler() {}
 
@@ -34,66 +45,34 @@ std::shared_ptr<streamfx::util::profiler::instance> streamfx::util::profiler::tr
 
 void streamfx::util::profiler::track(std::chrono::nanoseconds duration)
 {
-	std::unique_lock<std::mutex> ul(_timings_lock);
-	auto                         itr = _timings.find(duration);
-	if (itr == _timings.end()) {
-		_timings.emplace(duration, 1u);
-	} else {
-		itr->second++;
-	}
-}
+	auto value = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
 
-uint64_t streamfx::util::profiler::count()
-{
-	uint64_t count = 0;
+	_buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+	_total.fetch_add(value, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
 
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
-	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), std::inserter(copy_timings, copy_timings.end()));
+	for (uint64_t cur = _minimum.load(std::memory_order_relaxed);
+		 (value < cur) && !_minimum.compare_exchange_weak(cur, value, std::memory_order_relaxed);) {
 	}
-
-	for (auto kv : copy_timings) {
-		count += kv.second;
+	for (uint64_t cur = _maximum.load(std::memory_order_relaxed);
+		 (value > cur) && !_maximum.compare_exchange_weak(cur, value, std::memory_order_relaxed);) {
 	}
+}
 
-	return count;
+uint64_t streamfx::util::profiler::count()
+{
+	return _count.load(std::memory_order_relaxed);
 }
 
 std::chrono::nanoseconds streamfx::util::profiler::total_duration()
 {
-	std::chrono::nanoseconds duration{0};
-
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
-	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), std::inserter(copy_timings, copy_timings.end()));
-	}
-
-	for (auto kv : copy_timings) {
-		duration += kv.first * kv.second;
-	}
-
-	return duration;
+	return std::chrono::nanoseconds(_total.load(std::memory_order_relaxed));
 }
 
 double_t streamfx::util::profiler::average_duration()
 {
-	std::chrono::nanoseconds duration{0};
-	uint64_t                 count = 0;
-
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
-	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), std::inserter(copy_timings, copy_timings.end()));
-	}
-
-	for (auto kv : copy_timings) {
-		duration += kv.first * kv.second;
-		count += kv.second;
-	}
-
-	return double_t(duration.count()) / double_t(count);
+	// Sum and count are tracked exactly, so the average has no histogram error.
+	return double_t(_total.load(std::memory_order_relaxed)) / double_t(_count.load(std::memory_order_relaxed));
 }
 
 template<typename T>
@@ -104,42 +83,59 @@ inline bool is_equal(T a, T b, T c)
 
 std::chrono::nanoseconds streamfx::util::profiler::percentile(double_t percentile, bool by_time)
 {
-	constexpr double_t edge  = 0.00005;
-	uint64_t           calls = count();
-
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
-	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), inserter(copy_timings, copy_timings.end()));
+	constexpr double_t edge = 0.00005;
+
+	// Take a snapshot, so that concurrent tracking doesn't skew the result.
+	std::array<uint64_t, bucket_count> buckets;
+	uint64_t                           calls = 0;
+	for (size_t idx = 0; idx < bucket_count; idx++) {
+		buckets[idx] = _buckets[idx].load(std::memory_order_relaxed);
+		calls += buckets[idx];
+	}
+	if (calls == 0) {
+		return std::chrono::nanoseconds(-1);
 	}
+
+	// Bucket values are clamped to the exact extremes, which keeps 0% and 100% exact.
+	uint64_t smallest = _minimum.load(std::memory_order_relaxed);
+	uint64_t largest  = std::max(_maximum.load(std::memory_order_relaxed), smallest);
+	auto     value_of = [smallest, largest](size_t idx) {
+		return std::chrono::nanoseconds(std::clamp(bucket_value(idx), smallest, largest));
+	};
+
 	if (by_time) { // Return by time percentile.
-		// Find largest and smallest time.
-		std::chrono::nanoseconds smallest = copy_timings.begin()->first;
-		std::chrono::nanoseconds largest  = copy_timings.rbegin()->first;
-		std::chrono::nanoseconds variance = largest - smallest;
+		uint64_t variance = largest - smallest;
+		for (size_t idx = 0; idx < bucket_count; idx++) {
+			if (buckets[idx] == 0) {
+				continue;
+			}
 
-		for (auto kv : copy_timings) {
-			double_t kv_pct = double_t((kv.first - smallest).count()) / double_t(variance.count());
+			auto     value  = value_of(idx);
+			double_t kv_pct = (variance > 0) ? double_t(uint64_t(value.count()) - smallest) / double_t(variance) : 1.;
 			if (is_equal<double_t>(kv_pct, percentile, edge) || (kv_pct > percentile)) {
-				return std::chrono::nanoseconds(kv.first);
+				return value;
 			}
 		}
 	} else { // Return by call percentile.
 		if (percentile == 0.0) {
-			return copy_timings.begin()->first;
+			return std::chrono::nanoseconds(smallest);
 		}
 
 		uint64_t accu_calls_now = 0;
-		for (auto kv : copy_timings) {
+		for (size_t idx = 0; idx < bucket_count; idx++) {
+			if (buckets[idx] == 0) {
+				continue;
+			}
+
 			uint64_t accu_calls_last = accu_calls_now;
-			accu_calls_now += kv.second;
+			accu_calls_now += buckets[idx];
 
 			double_t percentile_last = double_t(accu_calls_last) / double_t(calls);
 			double_t percentile_now  = double_t(accu_calls_now) / double_t(calls);
 
 			if (is_equal<double_t>(percentile, percentile_now, edge)
 				|| ((percentile_last < percentile) && (percentile_now > percentile))) {
-				return std::chrono::nanoseconds(kv.first);
+				return value_of(idx);
 			}
 		}
 	}
@@ -147,6 +143,37 @@ std::chrono::nanoseconds streamfx::util::profiler::percentile(double_t percentil
 	return std::chrono::nanoseconds(-1);
 }
 
+size_t streamfx::util::profiler::bucket_index(uint64_t value)
+{
+	if (value < sub_bucket_count) {
+		return static_cast<size_t>(value);
+	}
+
+	// Position of the highest set bit selects the group, the bits below it the linear bucket within it.
+	size_t   msb = 0;
+	uint64_t v   = value;
+	for (size_t step = 32; step > 0; step >>= 1) {
+		if (v >> step) {
+			v >>= step;
+			msb += step;
+		}
+	}
+	size_t shift = msb - sub_bucket_bits;
+	return ((shift + 1) << sub_bucket_bits) + static_cast<size_t>((value >> shift) & (sub_bucket_count - 1));
+}
+
+uint64_t streamfx::util::profiler::bucket_value(size_t index)
+{
+	if (index < sub_bucket_count) {
+		return index;
+	}
+
+	// Report the middle of the bucket, which halves the worst case error.
+	size_t   shift = (index >> sub_bucket_bits) - 1;
+	uint64_t lower = (uint64_t(sub_bucket_count) | (index & (sub_bucket_count - 1))) << shift;
+	return lower + ((uint64_t(1) << shift) >> 1);
+}
+
 streamfx::util::profiler::instance::instance(std::shared_ptr<streamfx::util::profiler> parent)
 	: _parent(parent), _start(std::chrono::high_resolution_clock::now())
 {}
@@ -157,6 +184,11 @@ streamfx::util::profiler::instance::~instance()
 	auto dur = end - _start;
 	if (_parent) {
 		_parent->track(dur);
+#ifdef ENABLE_PROFILING
+		if (!_parent->_name.empty()) {
+			streamfx::util::trace::record(_parent->_name.c_str(), _start, end);
+		}
+#endif
 	}
 }
 
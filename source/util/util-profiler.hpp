@@ -21,15 +21,29 @@
 #include "common.hpp"
 
 #include "warning-disable.hpp"
+#include <array>
+#include <atomic>
 #include <chrono>
-#include <map>
-#include <mutex>
 #include "warning-enable.hpp"
 
 namespace streamfx::util {
 	class profiler : public std::enable_shared_from_this<streamfx::util::profiler> {
-		std::map<std::chrono::nanoseconds, size_t> _timings;
-		std::mutex                                 _timings_lock;
+		/** Log-linear histogram layout.
+		 *
+		 * Durations below 2^sub_bucket_bits nanoseconds are stored exactly, every power of two above that is split
+		 * into 2^sub_bucket_bits linear buckets. Reported durations are the middle of their bucket, and thus off by at
+		 * most 1/2^(sub_bucket_bits + 1) (~0.8%) of the true value, while the memory used stays fixed.
+		 */
+		static constexpr size_t sub_bucket_bits  = 6;
+		static constexpr size_t sub_bucket_count = size_t(1) << sub_bucket_bits;
+		static constexpr size_t bucket_count     = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+		std::array<std::atomic<uint64_t>, bucket_count> _buckets;
+		std::atomic<uint64_t>                           _count;
+		std::atomic<uint64_t>                           _total;
+		std::atomic<uint64_t>                           _minimum;
+		std::atomic<uint64_t>                           _maximum;
+		std::string                                     _name;
 
 		public:
 		class instance {
@@ -47,7 +61,7 @@ namespace streamfx::util {
 		};
 
 		private:
-		profiler();
+		profiler(std::string_view name);
 
 		public:
 		~profiler();
@@ -64,10 +78,19 @@ namespace streamfx::util {
 
 		std::chrono::nanoseconds percentile(double_t percentile, bool by_time = false);
 
+		private:
+		static size_t bucket_index(uint64_t value);
+
+		static uint64_t bucket_value(size_t index);
+
 		public:
-		static std::shared_ptr<streamfx::util::profiler> create()
+		/** Create a new profiler.
+		 *
+		 * @param name If not empty, every tracked instance is also recorded as a trace event with this name.
+		 */
+		static std::shared_ptr<streamfx::util::profiler> create(std::string_view name = {})
 		{
-			return std::shared_ptr<streamfx::util::profiler>{new profiler()};
+			return std::shared_ptr<streamfx::util::profiler>{new profiler(name)};
 		}
 	};
 } // namespace streamfx::util
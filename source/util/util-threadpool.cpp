@@ -18,7 +18,13 @@
 #include "common.hpp"
 #include "util/util-logging.hpp"
 
+#ifdef ENABLE_PROFILING
+#include "util/util-trace.hpp"
+#endif
+
 #include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include "warning-enable.hpp"
 
@@ -27,6 +33,7 @@
 #include <Windows.h>
 #elif defined(D_PLATFORM_LINUX)
 #include <pthread.h>
+#include <sched.h>
 #endif
 #include "warning-enable.hpp"
 
@@ -44,36 +51,231 @@
 #define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
 #endif
 
+static std::atomic<uint64_t> stat_submitted{0};
+static std::atomic<uint64_t> stat_block_allocations{0};
+static std::atomic<uint64_t> stat_callback_allocations{0};
+
+// Tasks don't carry their own mutex and condition variable. Threads waiting for a task park on one of these slots
+// instead, picked by the address of the task.
+struct wait_slot {
+	std::mutex              lock;
+	std::condition_variable cv;
+};
+static std::array<wait_slot, 16> wait_slots;
+
+static wait_slot& get_wait_slot(const void* ptr)
+{
+	return wait_slots[(reinterpret_cast<uintptr_t>(ptr) >> 6) % wait_slots.size()];
+}
+
+streamfx::util::threadpool::duration_histogram::duration_histogram() : _buckets()
+{
+	for (auto& bucket : _buckets) {
+		bucket = 0;
+	}
+}
+
+void streamfx::util::threadpool::duration_histogram::record(std::chrono::nanoseconds duration)
+{
+	auto   us  = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)) / 1000;
+	size_t idx = 0;
+	while ((us >>= 1) != 0) {
+		idx++;
+	}
+	_buckets[std::min(idx, histogram_buckets - 1)].fetch_add(1, std::memory_order_relaxed);
+}
+
+streamfx::util::threadpool::histogram_t streamfx::util::threadpool::duration_histogram::snapshot() const
+{
+	histogram_t result;
+	for (size_t idx = 0; idx < histogram_buckets; idx++) {
+		result[idx] = _buckets[idx].load(std::memory_order_relaxed);
+	}
+	return result;
+}
+
+std::chrono::microseconds streamfx::util::threadpool::histogram_percentile(const histogram_t& histogram,
+																			double      percentile)
+{
+	uint64_t total = 0;
+	for (auto count : histogram) {
+		total += count;
+	}
+	if (total == 0) {
+		return std::chrono::microseconds(0);
+	}
+
+	auto     limit = static_cast<uint64_t>(std::ceil(static_cast<double>(total) * std::clamp(percentile, 0., 1.)));
+	uint64_t accu  = 0;
+	for (size_t idx = 0; idx < histogram_buckets; idx++) {
+		accu += histogram[idx];
+		if (accu >= limit) {
+			return std::chrono::microseconds(2ull << idx);
+		}
+	}
+	return std::chrono::microseconds(2ull << (histogram_buckets - 1));
+}
+
+streamfx::util::threadpool::task_statistics streamfx::util::threadpool::get_task_statistics()
+{
+	return {stat_submitted.load(), stat_block_allocations.load(), stat_callback_allocations.load()};
+}
+
+void streamfx::util::threadpool::task_callback::track_heap_allocation()
+{
+	++stat_callback_allocations;
+}
+
+streamfx::util::threadpool::details::block_pool::block_pool(size_t size) : _lock(), _free(), _size(size)
+{
+	_free.reserve(256);
+}
+
+streamfx::util::threadpool::details::block_pool::~block_pool()
+{
+	for (auto block : _free) {
+		::operator delete(block);
+	}
+}
+
+void* streamfx::util::threadpool::details::block_pool::allocate()
+{
+	{
+		std::lock_guard<std::mutex> lg(_lock);
+		if (!_free.empty()) {
+			void* block = _free.back();
+			_free.pop_back();
+			return block;
+		}
+	}
+
+	++stat_block_allocations;
+	return ::operator new(_size);
+}
+
+void streamfx::util::threadpool::details::block_pool::free(void* block)
+{
+	{
+		std::lock_guard<std::mutex> lg(_lock);
+		if (_free.size() < _free.capacity()) { // Never grow the free list, so returning a block does not allocate.
+			_free.push_back(block);
+			return;
+		}
+	}
+
+	::operator delete(block);
+}
+
+streamfx::util::threadpool::task_queue::task_queue() : _head(), _tail(nullptr), _size(0) {}
+
+streamfx::util::threadpool::task_queue::~task_queue()
+{
+	// Unlink one by one, as destroying the head would otherwise recurse through the entire chain.
+	while (_head) {
+		pop_front();
+	}
+}
+
+void streamfx::util::threadpool::task_queue::push_back(std::shared_ptr<task> task)
+{
+	task->_next.reset();
+	if (_tail) {
+		_tail->_next = task;
+	} else {
+		_head = task;
+	}
+	_tail = task.get();
+	++_size;
+}
+
+std::shared_ptr<streamfx::util::threadpool::task> streamfx::util::threadpool::task_queue::pop_front()
+{
+	if (!_head) {
+		return nullptr;
+	}
+
+	auto task = std::move(_head);
+	_head     = std::move(task->_next);
+	if (!_head) {
+		_tail = nullptr;
+	}
+	--_size;
+	return task;
+}
+
+bool streamfx::util::threadpool::task_queue::remove(const std::shared_ptr<task>& task)
+{
+	if (!_head || !task) {
+		return false;
+	}
+
+	if (_head == task) {
+		pop_front();
+		return true;
+	}
+
+	for (auto prev = _head.get(); prev->_next; prev = prev->_next.get()) {
+		if (prev->_next == task) {
+			prev->_next = std::move(task->_next);
+			if (_tail == task.get()) {
+				_tail = prev;
+			}
+			--_size;
+			return true;
+		}
+	}
+
+	return false;
+}
+
 streamfx::util::threadpool::task::task(task_callback_t callback, task_data_t data)
-	: _callback(callback), _data(data), _lock(), _status_changed(), _cancelled(false), _completed(false), _failed(false)
+	: _callback(std::move(callback)), _data(std::move(data)), _next(), _state(state::QUEUED), _waiters(0),
+	  _cancelled(false), _completed(false), _failed(false), _pool(nullptr), _priority(priority::NORMAL),
+	  _dependencies(0), _dependents(), _resolved(false)
 {}
 
 streamfx::util::threadpool::task::~task() {}
 
 void streamfx::util::threadpool::task::run()
 {
-	std::lock_guard<std::mutex> lg(_lock);
+	state expected = state::QUEUED;
+	if (!_state.compare_exchange_strong(expected, state::RUNNING)) {
+		// Cancelled before it could run.
+		return;
+	}
+
 	if (!_cancelled) {
 		try {
 			_callback(_data);
 		} catch (const std::exception& ex) {
 			D_LOG_ERROR("Unhandled exception in Task: %s.", ex.what());
-			_failed = false;
+			_failed = true;
 		} catch (...) {
 			D_LOG_ERROR("Unhandled exception in Task.", nullptr);
 			_failed = true;
 		}
 	}
-	_completed = true;
-	_status_changed.notify_all();
+
+	// Release whatever the callback captured right away, instead of whenever the last handle goes away.
+	_callback.reset();
+	_data.reset();
+	finish();
 }
 
 void streamfx::util::threadpool::task::cancel()
 {
-	std::lock_guard<std::mutex> lg(_lock);
 	_cancelled = true;
-	_completed = true;
-	_status_changed.notify_all();
+
+	state expected = state::QUEUED;
+	if (_state.compare_exchange_strong(expected, state::FINISHED)) {
+		_callback.reset();
+		_data.reset();
+		finish();
+	} else {
+		// Like before, cancelling a running task blocks until it is done.
+		wait();
+		_completed = true;
+	}
 }
 
 bool streamfx::util::threadpool::task::is_cancelled()
@@ -93,11 +295,15 @@ bool streamfx::util::threadpool::task::has_failed()
 
 void streamfx::util::threadpool::task::wait()
 {
-	std::unique_lock<std::mutex> ul(_lock);
-	if (!_cancelled && !_completed && !_failed) {
-		_status_changed.wait(ul,
-							 [this]() { return this->is_completed() || this->is_cancelled() || this->has_failed(); });
+	if (_state == state::FINISHED) {
+		return;
 	}
+
+	auto&                        slot = get_wait_slot(this);
+	std::unique_lock<std::mutex> ul(slot.lock);
+	++_waiters;
+	slot.cv.wait(ul, [this]() { return _state == state::FINISHED; });
+	--_waiters;
 }
 
 void streamfx::util::threadpool::task::await_completion()
@@ -105,81 +311,478 @@ void streamfx::util::threadpool::task::await_completion()
 	wait();
 }
 
+void streamfx::util::threadpool::task::finish()
+{
+	_state     = state::FINISHED;
+	_completed = true;
+
+	// Only touch the shared wait slot if someone is actually waiting.
+	if (_waiters > 0) {
+		auto& slot = get_wait_slot(this);
+		{
+			std::lock_guard<std::mutex> lg(slot.lock);
+		}
+		slot.cv.notify_all();
+	}
+
+	// Release or cancel everything that was waiting on this task.
+	std::vector<std::shared_ptr<task>> dependents;
+	{
+		std::lock_guard<std::mutex> lg(get_wait_slot(this).lock);
+		_resolved = true;
+		dependents.swap(_dependents);
+	}
+	for (auto& dependent : dependents) {
+		resolve_dependency(dependent, !_cancelled && !_failed);
+	}
+}
+
+void streamfx::util::threadpool::task::add_dependent(std::shared_ptr<task> dependent)
+{
+	{
+		std::lock_guard<std::mutex> lg(get_wait_slot(this).lock);
+		if (!_resolved) {
+			_dependents.push_back(std::move(dependent));
+			return;
+		}
+	}
+
+	// Already finished, so resolve right away.
+	resolve_dependency(dependent, !_cancelled && !_failed);
+}
+
+void streamfx::util::threadpool::task::resolve_dependency(const std::shared_ptr<task>& dependent, bool succeeded)
+{
+	if (!succeeded) {
+		dependent->cancel();
+	}
+
+	if ((--dependent->_dependencies == 0) && (dependent->_state == state::QUEUED)) {
+		dependent->_pool->enqueue(dependent);
+	}
+}
+
+// Worker that owns the calling thread, if any. Tasks pushed from inside a task go to the local queue first.
+thread_local static std::pair<streamfx::util::threadpool::threadpool*, streamfx::util::threadpool::worker_info*>
+	local_worker{nullptr, nullptr};
+
 streamfx::util::threadpool::threadpool::~threadpool()
 {
-	{ // Terminate all remaining tasks.
-		std::lock_guard<std::mutex> lg(_tasks_lock);
-		for (auto task : _tasks) {
-			task->cancel();
+	// Tasks that become ready from now on are cancelled instead of queued.
+	_stopping = true;
+
+	for (auto& ln : _lanes) { // Terminate all remaining tasks.
+		for (auto worker : *workers(ln)) {
+			std::lock_guard<std::mutex> lg(worker->tasks_lock);
+			while (auto task = worker->tasks.pop_front()) {
+				task->cancel();
+				--ln.task_count;
+			}
 		}
-		_tasks.clear();
 	}
 
-	{ // Notify workers to stop working.
+	for (auto& ln : _lanes) { // Notify workers to stop working.
 		{
-			std::lock_guard<std::mutex> lg(_workers_lock);
-			for (auto worker : _workers) {
+			std::lock_guard<std::mutex> lg(ln.workers_lock);
+			for (auto worker : ln.workers) {
 				worker->stop = true;
 			}
 		}
 		{
-			std::lock_guard<std::mutex> lg(_tasks_lock);
-			_tasks_cv.notify_all();
+			std::lock_guard<std::mutex> lg(ln.tasks_lock);
+			ln.tasks_cv.notify_all();
 		}
-		for (auto worker : _workers) {
+	}
+
+	for (auto& ln : _lanes) { // Wait for workers to stop.
+		for (auto worker : ln.workers) {
 			std::lock_guard<std::mutex> lg(worker->lifeline);
 		}
 	}
 }
 
 streamfx::util::threadpool::threadpool::threadpool(size_t minimum, size_t maximum)
-	: _limits{minimum, maximum}, _workers_lock(), _workers(), _tasks_lock(), _tasks_cv(), _tasks()
+	: _lanes(), _stopping(false), _statistics_interval(0), _statistics_next(0), _statistics_lock(), _statistics_last(),
+	  _statistics_last_time(std::chrono::high_resolution_clock::now())
 {
+	for (auto& ln : _lanes) {
+		ln.worker_count     = 0;
+		ln.workers_snapshot = std::make_shared<const std::vector<std::shared_ptr<worker_info>>>();
+		ln.next_worker      = 0;
+		ln.task_count       = 0;
+		ln.idle_count       = 0;
+		ln.busy_count       = 0;
+		ln.queued_peak      = 0;
+		ln.spawned          = 0;
+		ln.died             = 0;
+		ln.executed         = 0;
+		ln.busy_time        = 0;
+	}
+
+	// Realtime work is rare but must start immediately, so keep one worker ready. Background work must never take
+	// over the whole machine, so it only gets half of the threads.
+	_lanes[static_cast<size_t>(priority::REALTIME)].limits   = {1, std::max<size_t>(1, maximum)};
+	_lanes[static_cast<size_t>(priority::NORMAL)].limits     = {minimum, maximum};
+	_lanes[static_cast<size_t>(priority::BACKGROUND)].limits = {1, std::max<size_t>(1, maximum / 2)};
+
 	// Spawn the minimum number of threads.
-	spawn(_limits.first);
+	for (size_t idx = 0; idx < priority_count; idx++) {
+		spawn(static_cast<priority>(idx), _lanes[idx].limits.first);
+	}
+}
+
+std::shared_ptr<streamfx::util::threadpool::task>
+	streamfx::util::threadpool::threadpool::push(task_callback_t callback, task_data_t data /*= nullptr*/,
+												 priority prio /*= priority::NORMAL*/)
+{
+	auto task = create(std::move(callback), std::move(data), prio);
+	enqueue(task);
+	return task;
 }
 
 std::shared_ptr<streamfx::util::threadpool::task>
-	streamfx::util::threadpool::threadpool::push(task_callback_t callback, task_data_t data /*= nullptr*/)
+	streamfx::util::threadpool::threadpool::then(std::shared_ptr<task> parent, task_callback_t callback,
+												 task_data_t data /*= nullptr*/, priority prio /*= priority::NORMAL*/)
 {
-	std::lock_guard<std::mutex> lg(_tasks_lock);
-	constexpr size_t            threshold = 3;
+	return when_all({parent}, std::move(callback), std::move(data), prio);
+}
 
-	// Enqueue the new task.
-	auto task = std::make_shared<streamfx::util::threadpool::task>(callback, data);
-	_tasks.emplace_back(task);
+std::shared_ptr<streamfx::util::threadpool::task> streamfx::util::threadpool::threadpool::when_all(
+	const std::vector<std::shared_ptr<task>>& parents, task_callback_t callback, task_data_t data /*= nullptr*/,
+	priority prio /*= priority::NORMAL*/)
+{
+	auto task = create(std::move(callback), std::move(data), prio);
+
+	// Hold one extra dependency while registering, so that the task can't start before all parents are known.
+	task->_dependencies = parents.size() + 1;
+	for (auto& parent : parents) {
+		if (parent) {
+			parent->add_dependent(task);
+		} else {
+			--task->_dependencies;
+		}
+	}
+	task::resolve_dependency(task, true);
 
-	// Spawn additional workers if the number of queued tasks exceeds a threshold.
-	if (_tasks.size() > (threshold * _worker_count)) {
-		spawn(_tasks.size() / threshold);
+	return task;
+}
+
+void streamfx::util::threadpool::threadpool::parallel_for(size_t count, size_t grain,
+															void (*callback)(void*, size_t, size_t), void* context,
+															priority prio /*= priority::NORMAL*/)
+{
+	// Aim for a few slices per thread, so that uneven slices still balance out.
+	constexpr size_t slices_per_thread = 4;
+
+	if (count == 0) {
+		return;
+	}
+	grain = std::max<size_t>(grain, 1);
+
+	auto&  ln      = _lanes.at(static_cast<size_t>(prio));
+	size_t threads = std::min<size_t>(std::max<size_t>(ln.limits.second, 1), (count + grain - 1) / grain);
+	if (threads <= 1) {
+		callback(context, 0, count);
+		return;
 	}
 
-	// Return handle to caller.
+	// Make sure there are enough workers to help, instead of waiting for the pool to notice the load.
+	if (ln.worker_count < (threads - 1)) {
+		spawn(prio, threads - 1 - ln.worker_count);
+	}
+
+	struct state_t {
+		std::atomic<size_t> next;
+		size_t              count;
+		size_t              slice;
+		void (*callback)(void*, size_t, size_t);
+		void* context;
+
+		void work()
+		{
+			for (size_t begin = next.fetch_add(slice); begin < count; begin = next.fetch_add(slice)) {
+				callback(context, begin, std::min(begin + slice, count));
+			}
+		}
+	} state;
+	state.next     = 0;
+	state.count    = count;
+	state.slice    = std::max(grain, (count + (threads * slices_per_thread) - 1) / (threads * slices_per_thread));
+	state.callback = callback;
+	state.context  = context;
+
+	// Helpers simply pull slices from the shared counter. Whichever helper doesn't get to run before the calling
+	// thread finished everything is cancelled, instead of waited on.
+	std::array<std::shared_ptr<task>, 64> helpers;
+	size_t                                helper_count = std::min(threads - 1, helpers.size());
+	for (size_t idx = 0; idx < helper_count; idx++) {
+		helpers[idx] = push([&state](task_data_t) { state.work(); }, nullptr, prio);
+	}
+
+	state.work();
+
+	for (size_t idx = 0; idx < helper_count; idx++) {
+		pop(helpers[idx]);
+	}
+}
+
+std::array<streamfx::util::threadpool::lane_statistics, streamfx::util::threadpool::priority_count>
+	streamfx::util::threadpool::threadpool::statistics()
+{
+	std::array<lane_statistics, priority_count> result;
+	for (size_t idx = 0; idx < priority_count; idx++) {
+		auto& ln   = _lanes[idx];
+		auto& info = result[idx];
+
+		info.workers      = ln.worker_count.load();
+		info.busy_workers = ln.busy_count.load();
+		info.queued       = ln.task_count.load();
+		info.queued_peak  = ln.queued_peak.load();
+		info.spawned      = ln.spawned.load();
+		info.died         = ln.died.load();
+		info.executed     = ln.executed.load();
+		info.busy_time    = std::chrono::nanoseconds(ln.busy_time.load());
+		info.wait_time    = ln.wait_time.snapshot();
+		info.run_time     = ln.run_time.snapshot();
+	}
+	return result;
+}
+
+void streamfx::util::threadpool::threadpool::log_statistics()
+{
+	static constexpr const char* names[priority_count] = {"Realtime", "Normal", "Background"};
+
+	std::lock_guard<std::mutex> lg(_statistics_lock);
+	auto                        now     = std::chrono::high_resolution_clock::now();
+	auto                        stats   = statistics();
+	auto                        elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - _statistics_last_time);
+
+	for (size_t idx = 0; idx < priority_count; idx++) {
+		auto& cur  = stats[idx];
+		auto& last = _statistics_last[idx];
+
+		// Share of the available worker time spent running tasks since the last log.
+		double utilisation = 0.;
+		if ((elapsed.count() > 0) && (cur.workers > 0)) {
+			utilisation = static_cast<double>((cur.busy_time - last.busy_time).count())
+						  / (static_cast<double>(elapsed.count()) * static_cast<double>(cur.workers));
+		}
+
+		D_LOG_INFO("%s: %zu workers (%zu busy, %.1f%% utilised, %llu spawned, %llu died), %zu queued (%zu peak), %llu "
+				   "executed.",
+				   names[idx], cur.workers, cur.busy_workers, utilisation * 100.,
+				   static_cast<unsigned long long>(cur.spawned), static_cast<unsigned long long>(cur.died), cur.queued,
+				   cur.queued_peak, static_cast<unsigned long long>(cur.executed));
+
+		// Only report what happened since the last log.
+		histogram_t wait_time, run_time;
+		for (size_t bdx = 0; bdx < histogram_buckets; bdx++) {
+			wait_time[bdx] = cur.wait_time[bdx] - last.wait_time[bdx];
+			run_time[bdx]  = cur.run_time[bdx] - last.run_time[bdx];
+		}
+		D_LOG_INFO("%s: Wait time p50 < %lldus, p99 < %lldus. Run time p50 < %lldus, p99 < %lldus.", names[idx],
+				   static_cast<long long>(histogram_percentile(wait_time, .50).count()),
+				   static_cast<long long>(histogram_percentile(wait_time, .99).count()),
+				   static_cast<long long>(histogram_percentile(run_time, .50).count()),
+				   static_cast<long long>(histogram_percentile(run_time, .99).count()));
+	}
+
+	_statistics_last      = stats;
+	_statistics_last_time = now;
+}
+
+void streamfx::util::threadpool::threadpool::set_statistics_interval(std::chrono::seconds interval)
+{
+	_statistics_interval = std::max<int64_t>(interval.count(), 0);
+	_statistics_next     = std::chrono::duration_cast<std::chrono::seconds>(
+							   std::chrono::steady_clock::now().time_since_epoch() + interval)
+							   .count();
+}
+
+void streamfx::util::threadpool::threadpool::maybe_log_statistics()
+{
+	int64_t interval = _statistics_interval.load(std::memory_order_relaxed);
+	if (interval <= 0) {
+		return;
+	}
+
+	// Whichever worker gets here first after the deadline does the logging.
+	int64_t now  = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch())
+					  .count();
+	int64_t next = _statistics_next.load(std::memory_order_relaxed);
+	if ((now >= next) && _statistics_next.compare_exchange_strong(next, now + interval)) {
+		log_statistics();
+	}
+}
+
+std::shared_ptr<streamfx::util::threadpool::task>
+	streamfx::util::threadpool::threadpool::create(task_callback_t callback, task_data_t data, priority prio)
+{
+	auto task = std::allocate_shared<streamfx::util::threadpool::task>(
+		details::pool_allocator<streamfx::util::threadpool::task>(), std::move(callback), std::move(data));
+	task->_pool     = this;
+	task->_priority = prio;
+
+	++stat_submitted;
 	return task;
 }
 
-void streamfx::util::threadpool::threadpool::pop(std::shared_ptr<task> task)
+void streamfx::util::threadpool::threadpool::enqueue(std::shared_ptr<task> task)
 {
-	if (task) {
+	constexpr size_t threshold = 3;
+
+	if (_stopping) {
 		task->cancel();
+		return;
+	}
+
+	auto  prio   = task->_priority;
+	auto& ln     = _lanes.at(static_cast<size_t>(prio));
+	bool  queued = false;
+
+	task->_enqueued = std::chrono::high_resolution_clock::now();
+
+	// Workers pushing follow-up work keep it local, as it is likely to touch the same data.
+	if ((local_worker.first == this) && (local_worker.second->prio == prio)) {
+		auto                        wi = local_worker.second;
+		std::lock_guard<std::mutex> lg(wi->tasks_lock);
+		if (!wi->retired) {
+			wi->tasks.push_back(task);
+			++ln.task_count;
+			queued = true;
+		}
+	}
+
+	// Everyone else distributes tasks round-robin, skipping workers that are about to die.
+	while (!queued) {
+		auto snapshot = workers(ln);
+		if (snapshot->empty()) {
+			spawn(prio);
+			if (workers(ln)->empty()) {
+				throw std::runtime_error("Thread pool has no workers.");
+			}
+			continue;
+		}
+
+		size_t start = ln.next_worker.fetch_add(1, std::memory_order_relaxed);
+		for (size_t idx = 0; (idx < snapshot->size()) && !queued; idx++) {
+			auto                        wi = snapshot->at((start + idx) % snapshot->size());
+			std::lock_guard<std::mutex> lg(wi->tasks_lock);
+			if (!wi->retired) {
+				wi->tasks.push_back(task);
+				++ln.task_count;
+				queued = true;
+			}
+		}
+	}
+
+	// Track the deepest the queue has ever been.
+	size_t tasks = ln.task_count.load();
+	for (size_t peak = ln.queued_peak.load(); (tasks > peak) && !ln.queued_peak.compare_exchange_weak(peak, tasks);) {
+	}
+
+	// Spawn additional workers if the number of queued tasks exceeds a threshold.
+	if (tasks > (threshold * ln.worker_count)) {
+		spawn(prio, tasks / threshold);
+	}
+
+	// Wake up an idle worker, if there is any.
+	if (ln.idle_count > 0) {
+		{
+			std::lock_guard<std::mutex> lg(ln.tasks_lock);
+		}
+		ln.tasks_cv.notify_one();
 	}
-	std::lock_guard<std::mutex> lg(_tasks_lock);
-	_tasks.remove(task);
 }
 
-void streamfx::util::threadpool::threadpool::spawn(size_t count)
+void streamfx::util::threadpool::threadpool::pop(std::shared_ptr<task> task)
 {
-	std::lock_guard<std::mutex> lg(_workers_lock);
-	for (size_t n = 0; (n < count) && (_worker_count < _limits.second); n++) {
+	if (!task) {
+		return;
+	}
+
+	task->cancel();
+	for (auto& ln : _lanes) {
+		for (auto wi : *workers(ln)) {
+			std::lock_guard<std::mutex> lg(wi->tasks_lock);
+			if (wi->tasks.remove(task)) {
+				--ln.task_count;
+				return;
+			}
+		}
+	}
+}
+
+std::shared_ptr<const std::vector<std::shared_ptr<streamfx::util::threadpool::worker_info>>>
+	streamfx::util::threadpool::threadpool::workers(lane& ln)
+{
+	return std::atomic_load(&ln.workers_snapshot);
+}
+
+void streamfx::util::threadpool::threadpool::publish_workers(lane& ln)
+{
+	// Must be called with workers_lock held.
+	std::atomic_store(&ln.workers_snapshot, std::make_shared<const std::vector<std::shared_ptr<worker_info>>>(
+												ln.workers.begin(), ln.workers.end()));
+}
+
+std::shared_ptr<streamfx::util::threadpool::task>
+	streamfx::util::threadpool::threadpool::acquire(lane& ln, std::shared_ptr<worker_info> wi)
+{
+	std::shared_ptr<streamfx::util::threadpool::task> task;
+
+	{ // Check our own queue first.
+		std::lock_guard<std::mutex> lg(wi->tasks_lock);
+		if (task = wi->tasks.pop_front(); task) {
+			--ln.task_count;
+			return task;
+		}
+	}
+
+	// Otherwise try to steal from the other workers of this lane, starting at a different one each time.
+	if (ln.task_count == 0) {
+		return nullptr;
+	}
+	auto   snapshot = workers(ln);
+	size_t start    = ln.next_worker.load(std::memory_order_relaxed);
+	for (size_t idx = 0; idx < snapshot->size(); idx++) {
+		auto victim = snapshot->at((start + idx) % snapshot->size());
+		if (victim == wi) {
+			continue;
+		}
+
+		std::lock_guard<std::mutex> lg(victim->tasks_lock);
+		if (task = victim->tasks.pop_front(); task) {
+			--ln.task_count;
+			return task;
+		}
+	}
+
+	return nullptr;
+}
+
+void streamfx::util::threadpool::threadpool::spawn(priority prio, size_t count)
+{
+	auto&                       ln = _lanes.at(static_cast<size_t>(prio));
+	std::lock_guard<std::mutex> lg(ln.workers_lock);
+	size_t                      spawned = 0;
+	for (size_t n = 0; (n < count) && (ln.worker_count < ln.limits.second); n++) {
 		auto wi            = std::make_shared<worker_info>();
+		wi->prio           = prio;
 		wi->stop           = false;
+		wi->retired        = false;
 		wi->last_work_time = std::chrono::high_resolution_clock::now();
 		wi->thread         = std::thread(std::bind(&streamfx::util::threadpool::threadpool::work, this, wi));
 		wi->thread.detach();
-		_workers.emplace_back(wi);
-		++_worker_count;
-		D_LOG_DEBUG("Spawning new worker thread (%zu < %zu < %zu).", _limits.first, _worker_count.load(),
-					_limits.second);
+		ln.workers.emplace_back(wi);
+		++ln.worker_count;
+		++ln.spawned;
+		++spawned;
+		D_LOG_DEBUG("Spawning new worker thread for priority %zu (%zu < %zu < %zu).",
+					static_cast<size_t>(prio), ln.limits.first, ln.worker_count.load(), ln.limits.second);
+	}
+	if (spawned > 0) {
+		publish_workers(ln);
 	}
 }
 
@@ -187,19 +790,30 @@ bool streamfx::util::threadpool::threadpool::die(std::shared_ptr<worker_info> wi
 {
 	constexpr std::chrono::seconds delay{1};
 
-	std::lock_guard<std::mutex> lg(_workers_lock);
+	auto&                       ln = _lanes.at(static_cast<size_t>(wi->prio));
+	std::lock_guard<std::mutex> lg(ln.workers_lock);
 	bool                        result = false;
 
-	if (_worker_count > _limits.first) {
+	if (ln.worker_count > ln.limits.first) {
 		auto now = std::chrono::high_resolution_clock::now();
-		result   = ((wi->last_work_time + delay) <= now) && ((_last_worker_death + delay) <= now);
+		result   = ((wi->last_work_time + delay) <= now) && ((ln.last_worker_death + delay) <= now);
+
+		if (result) { // Only retire with an empty queue, so that no task is left behind.
+			std::lock_guard<std::mutex> lg2(wi->tasks_lock);
+			result = wi->tasks.empty();
+			if (result) {
+				wi->retired = true;
+			}
+		}
 
 		if (result) {
-			_last_worker_death = now;
-			--_worker_count;
-			_workers.remove(wi);
-			D_LOG_DEBUG("Terminated idle worker thread (%zu < %zu < %zu).", _limits.first, _worker_count.load(),
-						_limits.second);
+			ln.last_worker_death = now;
+			--ln.worker_count;
+			++ln.died;
+			ln.workers.remove(wi);
+			publish_workers(ln);
+			D_LOG_DEBUG("Terminated idle worker thread for priority %zu (%zu < %zu < %zu).",
+						static_cast<size_t>(wi->prio), ln.limits.first, ln.worker_count.load(), ln.limits.second);
 		}
 	}
 
@@ -210,48 +824,112 @@ void streamfx::util::threadpool::threadpool::work(std::shared_ptr<worker_info> w
 {
 	std::shared_ptr<streamfx::util::threadpool::task> task{};
 	std::lock_guard<std::mutex>                       lg(wi->lifeline);
+	auto&                                             ln = _lanes.at(static_cast<size_t>(wi->prio));
+
+	local_worker = {this, wi.get()};
 
 #if defined(D_PLATFORM_WINDOWS)
-	SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN | THREAD_PRIORITY_BELOW_NORMAL);
-	SetThreadDescription(GetCurrentThread(), L"StreamFX Worker Thread");
+	switch (wi->prio) {
+	case priority::REALTIME:
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+		SetThreadDescription(GetCurrentThread(), L"StreamFX Worker Thread (Realtime)");
+		break;
+	case priority::NORMAL:
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_NORMAL);
+		SetThreadDescription(GetCurrentThread(), L"StreamFX Worker Thread");
+		break;
+	case priority::BACKGROUND:
+		SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN | THREAD_PRIORITY_BELOW_NORMAL);
+		SetThreadDescription(GetCurrentThread(), L"StreamFX Worker Thread (Background)");
+		break;
+	}
 #elif defined(D_PLATFORM_LINUX)
 	struct sched_param param;
 	param.sched_priority = 0;
-	pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
-	pthread_setname_np(pthread_self(), "StreamFX Worker Thread");
+	switch (wi->prio) {
+	case priority::REALTIME:
+		// Real-time scheduling requires privileges, so fall back to the default policy if we don't have them.
+		param.sched_priority = sched_get_priority_min(SCHED_RR);
+		if (pthread_setschedparam(pthread_self(), SCHED_RR, &param) != 0) {
+			param.sched_priority = 0;
+			pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+		}
+		pthread_setname_np(pthread_self(), "StreamFX RT");
+		break;
+	case priority::NORMAL:
+		pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+		pthread_setname_np(pthread_self(), "StreamFX Worker");
+		break;
+	case priority::BACKGROUND:
+		pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+		pthread_setname_np(pthread_self(), "StreamFX BG");
+		break;
+	}
+#endif
+
+#ifdef ENABLE_PROFILING
+	static constexpr const char* trace_thread_names[priority_count] = {
+		"StreamFX Worker (Realtime)",
+		"StreamFX Worker",
+		"StreamFX Worker (Background)",
+	};
+	static constexpr const char* trace_task_names[priority_count] = {
+		"Task (Realtime)",
+		"Task",
+		"Task (Background)",
+	};
+	streamfx::util::trace::set_thread_name(trace_thread_names[static_cast<size_t>(wi->prio)]);
 #endif
 
 	while (!wi->stop) {
-		{ // Try and acquire new work.
-			std::unique_lock<std::mutex> ul(_tasks_lock);
-
-			// Is there any work available right now?
-			if (_tasks.size() == 0) { // If not:
-				// Block this thread until it is notified of a change.
-				_tasks_cv.wait_until(
-					ul,
-					std::chrono::time_point(std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(250)),
-					[this, wi]() { return wi->stop || _tasks.size() > 0; });
+		// Try and acquire new work, either from our own queue or from another worker.
+		task = acquire(ln, wi);
+
+		if (!task) { // If there is none, block this thread until it is notified of a change.
+			++ln.idle_count;
+			{
+				std::unique_lock<std::mutex> ul(ln.tasks_lock);
+				ln.tasks_cv.wait_for(ul, std::chrono::milliseconds(250),
+									 [&ln, wi]() { return wi->stop || (ln.task_count > 0); });
 			}
+			--ln.idle_count;
 
 			// If we were asked to stop, skip everything.
 			if (wi->stop) {
 				continue;
 			}
 
-			// If there is work to be done, take it.
-			if (_tasks.size() > 0) {
-				wi->last_work_time = std::chrono::high_resolution_clock::now();
-				task               = _tasks.front();
-				_tasks.pop_front();
-			} else if (die(wi)) { // Is the threadpool requesting less threads?
-				break;
+			maybe_log_statistics();
+
+			task = acquire(ln, wi);
+			if (!task) {
+				if (die(wi)) { // Is the threadpool requesting less threads?
+					break;
+				}
+				continue;
 			}
 		}
 
-		if (task) {
-			task->run();
-			task.reset();
-		}
+		auto start         = std::chrono::high_resolution_clock::now();
+		wi->last_work_time = start;
+		ln.wait_time.record(start - task->_enqueued);
+
+		++ln.busy_count;
+		task->run();
+		task.reset();
+		--ln.busy_count;
+
+		auto end      = std::chrono::high_resolution_clock::now();
+		auto duration = end - start;
+		ln.run_time.record(duration);
+#ifdef ENABLE_PROFILING
+		streamfx::util::trace::record(trace_task_names[static_cast<size_t>(wi->prio)], start, end);
+#endif
+		ln.busy_time += std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+		++ln.executed;
+
+		maybe_log_statistics();
 	}
+
+	local_worker = {nullptr, nullptr};
 }
@@ -16,6 +16,7 @@
 
 #pragma once
 #include "warning-disable.hpp"
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cinttypes>
@@ -28,18 +29,290 @@
 #include <new>
 #include <stdexcept>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include "warning-enable.hpp"
 
 namespace streamfx::util::threadpool {
-	typedef std::shared_ptr<void>            task_data_t;
-	typedef std::function<void(task_data_t)> task_callback_t;
+	typedef std::shared_ptr<void> task_data_t;
+
+	class task;
+
+	// Move-only replacement for std::function<void(task_data_t)>, which stores small callables (a lambda with a few
+	// captures, or a bound member function) inline instead of on the heap.
+	class task_callback {
+		static constexpr size_t capacity = 6 * sizeof(void*);
+
+		struct vtable {
+			void (*invoke)(void*, task_data_t);
+			void (*move)(void*, void*);
+			void (*destroy)(void*);
+		};
+
+		template<typename T, bool Inline>
+		struct operations {
+			static T* get(void* storage)
+			{
+				if constexpr (Inline) {
+					return std::launder(reinterpret_cast<T*>(storage));
+				} else {
+					return *reinterpret_cast<T**>(storage);
+				}
+			}
+
+			static void invoke(void* storage, task_data_t data)
+			{
+				(*get(storage))(std::move(data));
+			}
+
+			static void move(void* from, void* to)
+			{
+				if constexpr (Inline) {
+					new (to) T(std::move(*get(from)));
+					get(from)->~T();
+				} else {
+					*reinterpret_cast<T**>(to) = get(from);
+				}
+			}
+
+			static void destroy(void* storage)
+			{
+				if constexpr (Inline) {
+					get(storage)->~T();
+				} else {
+					delete get(storage);
+				}
+			}
+
+			static constexpr vtable table{&invoke, &move, &destroy};
+		};
+
+		alignas(std::max_align_t) unsigned char _storage[capacity];
+		const vtable* _vtable;
+
+		static void track_heap_allocation();
+
+		public:
+		task_callback() : _storage(), _vtable(nullptr) {}
+
+		template<typename T, typename = std::enable_if_t<!std::is_same_v<std::decay_t<T>, task_callback>>>
+		task_callback(T&& callable) : _storage(), _vtable(nullptr)
+		{
+			using type                   = std::decay_t<T>;
+			constexpr bool store_inline = (sizeof(type) <= capacity) && (alignof(type) <= alignof(std::max_align_t))
+										  && std::is_nothrow_move_constructible_v<type>;
+
+			if constexpr (store_inline) {
+				new (_storage) type(std::forward<T>(callable));
+			} else {
+				*reinterpret_cast<type**>(_storage) = new type(std::forward<T>(callable));
+				track_heap_allocation();
+			}
+			_vtable = &operations<type, store_inline>::table;
+		}
+
+		task_callback(task_callback&& other) noexcept : _storage(), _vtable(other._vtable)
+		{
+			if (_vtable) {
+				_vtable->move(other._storage, _storage);
+				other._vtable = nullptr;
+			}
+		}
+
+		task_callback& operator=(task_callback&& other) noexcept
+		{
+			if (this != &other) {
+				reset();
+				if ((_vtable = other._vtable) != nullptr) {
+					_vtable->move(other._storage, _storage);
+					other._vtable = nullptr;
+				}
+			}
+			return *this;
+		}
+
+		task_callback(const task_callback&)            = delete;
+		task_callback& operator=(const task_callback&) = delete;
+
+		~task_callback()
+		{
+			reset();
+		}
+
+		void reset()
+		{
+			if (_vtable) {
+				_vtable->destroy(_storage);
+				_vtable = nullptr;
+			}
+		}
+
+		void operator()(task_data_t data)
+		{
+			_vtable->invoke(_storage, std::move(data));
+		}
+
+		explicit operator bool() const
+		{
+			return _vtable != nullptr;
+		}
+	};
+	typedef task_callback task_callback_t;
+
+	// Intrusive FIFO of tasks, linked through task::_next so that queueing never allocates.
+	class task_queue {
+		std::shared_ptr<task> _head;
+		task*                 _tail;
+		size_t                _size;
+
+		public:
+		task_queue();
+		~task_queue();
+
+		void                  push_back(std::shared_ptr<task> task);
+		std::shared_ptr<task> pop_front();
+		bool                  remove(const std::shared_ptr<task>& task);
+
+		bool empty() const
+		{
+			return _size == 0;
+		}
+
+		size_t size() const
+		{
+			return _size;
+		}
+	};
+
+	namespace details {
+		// Keeps freed memory blocks of a single size around for reuse, so that steady-state task creation does not
+		// have to go through the heap.
+		class block_pool {
+			std::mutex         _lock;
+			std::vector<void*> _free;
+			size_t             _size;
+
+			public:
+			block_pool(size_t size);
+			~block_pool();
+
+			void* allocate();
+			void  free(void* block);
+		};
+
+		// Allocator for std::allocate_shared, which places task and control block in one recycled block.
+		template<typename T>
+		struct pool_allocator {
+			typedef T value_type;
+
+			pool_allocator() noexcept = default;
+			template<typename U>
+			pool_allocator(const pool_allocator<U>&) noexcept
+			{}
+
+			static block_pool& pool()
+			{
+				static block_pool instance{sizeof(T)};
+				return instance;
+			}
+
+			T* allocate(size_t count)
+			{
+				if (count != 1) {
+					return static_cast<T*>(::operator new(sizeof(T) * count));
+				}
+				return static_cast<T*>(pool().allocate());
+			}
+
+			void deallocate(T* ptr, size_t count) noexcept
+			{
+				if (count != 1) {
+					::operator delete(ptr);
+				} else {
+					pool().free(ptr);
+				}
+			}
+
+			template<typename U>
+			bool operator==(const pool_allocator<U>&) const noexcept
+			{
+				return true;
+			}
+
+			template<typename U>
+			bool operator!=(const pool_allocator<U>&) const noexcept
+			{
+				return false;
+			}
+		};
+	} // namespace details
+
+	struct task_statistics {
+		uint64_t submitted;            // Tasks pushed in total.
+		uint64_t block_allocations;    // Task memory blocks that had to come from the heap.
+		uint64_t callback_allocations; // Callbacks that were too large to be stored inline.
+	};
+
+	// Global counters, used to verify that submitting a task does not allocate in steady state.
+	task_statistics get_task_statistics();
+
+	enum class priority : uint8_t {
+		REALTIME,   // Latency-sensitive work on the audio and video path.
+		NORMAL,     // Regular work, like switching providers.
+		BACKGROUND, // Work that may be delayed arbitrarily, like saving files or checking for updates.
+	};
+	constexpr size_t priority_count = 3;
+
+	// Histogram of durations with power-of-two buckets. Bucket n holds durations of [2^n, 2^(n+1)) microseconds,
+	// except for bucket 0 which holds everything below 2 microseconds.
+	constexpr size_t histogram_buckets = 32;
+	typedef std::array<uint64_t, histogram_buckets> histogram_t;
+
+	class duration_histogram {
+		std::array<std::atomic<uint64_t>, histogram_buckets> _buckets;
+
+		public:
+		duration_histogram();
+
+		void record(std::chrono::nanoseconds duration);
+
+		histogram_t snapshot() const;
+	};
+
+	// Upper bound of the bucket that contains the given percentile (0..1) of all samples.
+	std::chrono::microseconds histogram_percentile(const histogram_t& histogram, double percentile);
+
+	struct lane_statistics {
+		size_t                   workers;      // Workers currently alive.
+		size_t                   busy_workers; // Workers currently running a task.
+		size_t                   queued;       // Tasks currently waiting to run.
+		size_t                   queued_peak;  // Highest number of waiting tasks seen so far.
+		uint64_t                 spawned;      // Workers spawned in total.
+		uint64_t                 died;         // Workers terminated for being idle in total.
+		uint64_t                 executed;     // Tasks run in total.
+		std::chrono::nanoseconds busy_time;    // Time spent running tasks in total, across all workers.
+		histogram_t              wait_time;    // Time from being queued to starting to run.
+		histogram_t              run_time;     // Time spent running.
+	};
 
 	struct worker_info {
+		priority prio;
+
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
 #endif
 			std::atomic<bool> stop;
 
+		// Per-worker task queue. The owner and thieves both take from the front, so the oldest task always runs
+		// first, while pushes from different threads only contend if they target the same worker.
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::mutex tasks_lock;
+		task_queue tasks;
+		bool       retired;
+
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
 #endif
@@ -50,27 +323,36 @@ namespace streamfx::util::threadpool {
 		std::thread thread;
 	};
 
+	class threadpool;
+
 	class task {
-		task_callback_t _callback;
-		task_data_t     _data;
-		std::mutex      _lock;
+		friend class task_queue;
+		friend class threadpool;
 
-#if __cpp_lib_hardware_interference_size >= 201603
-		alignas(std::hardware_destructive_interference_size)
-#endif
-			std::condition_variable _status_changed;
-#if __cpp_lib_hardware_interference_size >= 201603
-		alignas(std::hardware_destructive_interference_size)
-#endif
-			std::atomic<bool> _cancelled;
-#if __cpp_lib_hardware_interference_size >= 201603
-		alignas(std::hardware_destructive_interference_size)
-#endif
-			std::atomic<bool> _completed;
-#if __cpp_lib_hardware_interference_size >= 201603
-		alignas(std::hardware_destructive_interference_size)
-#endif
-			std::atomic<bool> _failed;
+		enum class state : uint8_t {
+			QUEUED,
+			RUNNING,
+			FINISHED,
+		};
+
+		task_callback_t       _callback;
+		task_data_t           _data;
+		std::shared_ptr<task> _next;
+
+		std::atomic<state>    _state;
+		std::atomic<uint32_t> _waiters;
+		std::atomic<bool>     _cancelled;
+		std::atomic<bool>     _completed;
+		std::atomic<bool>     _failed;
+
+		std::chrono::high_resolution_clock::time_point _enqueued;
+
+		// Dependency tracking for then() and when_all(). _dependents and _resolved are guarded by the wait slot lock.
+		threadpool*                        _pool;
+		priority                           _priority;
+		std::atomic<size_t>                _dependencies;
+		std::vector<std::shared_ptr<task>> _dependents;
+		bool                               _resolved;
 
 		public:
 		task(task_callback_t callback, task_data_t data);
@@ -98,31 +380,83 @@ namespace streamfx::util::threadpool {
 
 		public:
 		void await_completion();
+
+		private:
+		void finish();
+
+		private:
+		void add_dependent(std::shared_ptr<task> dependent);
+
+		private:
+		static void resolve_dependency(const std::shared_ptr<task>& dependent, bool succeeded);
 	};
 
-	class threadpool {
-		std::pair<size_t, size_t> _limits;
+	// Every priority has its own workers, queues and scheduling policy, so that work of one priority never has to
+	// wait behind work of another priority.
+	struct lane {
+		std::pair<size_t, size_t> limits;
 
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
 #endif
-			std::mutex _workers_lock;
-		std::list<std::shared_ptr<worker_info>> _workers;
+			std::mutex workers_lock;
+		std::list<std::shared_ptr<worker_info>> workers;
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
 #endif
-			std::atomic<size_t> _worker_count;
-		std::chrono::high_resolution_clock::time_point _last_worker_death;
+			std::atomic<size_t> worker_count;
+		std::chrono::high_resolution_clock::time_point last_worker_death;
 
+		// Immutable copy of workers, replaced whenever a worker is spawned or dies. Lets push() and stealing
+		// workers iterate all queues without holding workers_lock.
+		std::shared_ptr<const std::vector<std::shared_ptr<worker_info>>> workers_snapshot;
+
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::atomic<size_t> next_worker;
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
 #endif
-			std::mutex _tasks_lock;
+			std::atomic<size_t> task_count;
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
 #endif
-			std::condition_variable _tasks_cv;
-		std::list<std::shared_ptr<task>> _tasks;
+			std::atomic<size_t> idle_count;
+
+		// Telemetry, see lane_statistics.
+		std::atomic<size_t>   busy_count;
+		std::atomic<size_t>   queued_peak;
+		std::atomic<uint64_t> spawned;
+		std::atomic<uint64_t> died;
+		std::atomic<uint64_t> executed;
+		std::atomic<int64_t>  busy_time;
+		duration_histogram    wait_time;
+		duration_histogram    run_time;
+
+		// Only used to put idle workers to sleep, never to access tasks.
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::mutex tasks_lock;
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::condition_variable tasks_cv;
+	};
+
+	class threadpool {
+		friend class task;
+
+		std::array<lane, priority_count> _lanes;
+		std::atomic<bool>                _stopping;
+
+		// Periodic statistics logging, disabled if the interval is zero.
+		std::atomic<int64_t>                           _statistics_interval;
+		std::atomic<int64_t>                           _statistics_next;
+		std::mutex                                     _statistics_lock;
+		std::array<lane_statistics, priority_count>    _statistics_last;
+		std::chrono::high_resolution_clock::time_point _statistics_last_time;
 
 		public:
 		~threadpool();
@@ -131,13 +465,89 @@ namespace streamfx::util::threadpool {
 		threadpool(size_t minimum = 2, size_t maximum = std::thread::hardware_concurrency());
 
 		public:
-		std::shared_ptr<task> push(task_callback_t callback, task_data_t data = nullptr);
+		std::shared_ptr<task> push(task_callback_t callback, task_data_t data = nullptr,
+								   priority prio = priority::NORMAL);
 
 		public:
 		void pop(std::shared_ptr<task> task);
 
+		public:
+		/** Queue a task that runs once parent has completed.
+		 *
+		 * If parent is cancelled or fails, the new task is cancelled instead, as are all tasks depending on it.
+		 */
+		std::shared_ptr<task> then(std::shared_ptr<task> parent, task_callback_t callback, task_data_t data = nullptr,
+								   priority prio = priority::NORMAL);
+
+		public:
+		/** Queue a task that runs once all parents have completed.
+		 *
+		 * If any parent is cancelled or fails, the new task is cancelled instead, as are all tasks depending on it.
+		 */
+		std::shared_ptr<task> when_all(const std::vector<std::shared_ptr<task>>& parents, task_callback_t callback,
+									   task_data_t data = nullptr, priority prio = priority::NORMAL);
+
+		public:
+		/** Split the range [0, count) into slices of at least grain elements and process them in parallel.
+		 *
+		 * The calling thread processes slices as well and only returns once every slice is done, so the callback
+		 * may safely reference local state. The callback must not throw.
+		 *
+		 * @param callback Called as callback(begin, end) for every slice.
+		 * @param prio Lane to run helpers on. Slices may occupy every core, so this should not be REALTIME for bulk
+		 *             work, as that would preempt the graphics and audio threads of libOBS.
+		 */
+		template<typename T>
+		void parallel_for(size_t count, size_t grain, T&& callback, priority prio = priority::NORMAL)
+		{
+			using type = std::remove_reference_t<T>;
+			parallel_for(
+				count, grain,
+				[](void* context, size_t begin, size_t end) { (*static_cast<type*>(context))(begin, end); },
+				const_cast<void*>(static_cast<const void*>(&callback)), prio);
+		}
+
+		public:
+		void parallel_for(size_t count, size_t grain, void (*callback)(void*, size_t, size_t), void* context,
+						  priority prio = priority::NORMAL);
+
+		public:
+		std::array<lane_statistics, priority_count> statistics();
+
+		public:
+		/** Write the current statistics of every priority to the log.
+		 *
+		 * Utilisation is calculated from the time spent running tasks since the previous call.
+		 */
+		void log_statistics();
+
+		public:
+		/** Periodically log statistics from the worker threads.
+		 *
+		 * @param interval Time between two logs, or zero to disable.
+		 */
+		void set_statistics_interval(std::chrono::seconds interval);
+
+		private:
+		void maybe_log_statistics();
+
+		private:
+		std::shared_ptr<task> create(task_callback_t callback, task_data_t data, priority prio);
+
+		private:
+		void enqueue(std::shared_ptr<task> task);
+
+		private:
+		std::shared_ptr<const std::vector<std::shared_ptr<worker_info>>> workers(lane& ln);
+
+		private:
+		void publish_workers(lane& ln);
+
+		private:
+		std::shared_ptr<task> acquire(lane& ln, std::shared_ptr<worker_info> wi);
+
 		private:
-		void spawn(size_t count = 1);
+		void spawn(priority prio, size_t count = 1);
 
 		private:
 		bool die(std::shared_ptr<worker_info>);
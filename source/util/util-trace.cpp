@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2022 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "util-trace.hpp"
+#include "common.hpp"
+#include "util/util-logging.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <list>
+#include <mutex>
+#include "warning-enable.hpp"
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<util::trace> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+namespace {
+	constexpr size_t event_capacity = 8192; // Must be a power of two.
+	constexpr size_t name_words     = 5;
+	constexpr size_t name_length    = name_words * sizeof(uint64_t);
+	constexpr size_t retired_limit  = 32;
+
+	// All fields are atomic so that a concurrent dump can read a slot while its owner overwrites it. The sequence
+	// number tells the reader whether the copy it took is intact.
+	struct event {
+		// Index + 1 of the event stored in this slot, or 0 while it is being written.
+		std::atomic<uint64_t>                         sequence;
+		std::atomic<int64_t>                          start;
+		std::atomic<int64_t>                          duration;
+		std::array<std::atomic<uint64_t>, name_words> name;
+	};
+
+	struct thread_buffer {
+		uint64_t                          id;
+		std::string                       name;
+		bool                              retired;
+		std::atomic<uint64_t>             head;
+		std::array<event, event_capacity> events;
+	};
+
+	struct registry {
+		std::mutex                                     lock;
+		std::list<std::shared_ptr<thread_buffer>>      buffers;
+		uint64_t                                       next_id = 1;
+		std::chrono::high_resolution_clock::time_point epoch   = std::chrono::high_resolution_clock::now();
+
+		static registry& instance()
+		{
+			static registry instance;
+			return instance;
+		}
+	};
+
+	// Keeps the buffer registered for as long as the thread lives, and marks it as retired afterwards.
+	struct thread_holder {
+		std::shared_ptr<thread_buffer> buffer;
+
+		thread_holder()
+		{
+			auto& reg = registry::instance();
+
+			buffer          = std::make_shared<thread_buffer>();
+			buffer->retired = false;
+			buffer->head    = 0;
+			for (auto& ev : buffer->events) {
+				ev.sequence = 0;
+			}
+
+			std::lock_guard<std::mutex> lg(reg.lock);
+			buffer->id   = reg.next_id++;
+			buffer->name = "Thread " + std::to_string(buffer->id);
+			reg.buffers.push_back(buffer);
+		}
+
+		~thread_holder()
+		{
+			auto& reg = registry::instance();
+
+			std::lock_guard<std::mutex> lg(reg.lock);
+			buffer->retired = true;
+
+			// Keep the events of a few dead threads around, but not forever.
+			size_t retired = 0;
+			for (auto itr = reg.buffers.rbegin(); itr != reg.buffers.rend();) {
+				if ((*itr)->retired && (++retired > retired_limit)) {
+					itr = std::list<std::shared_ptr<thread_buffer>>::reverse_iterator(
+						reg.buffers.erase(std::next(itr).base()));
+				} else {
+					++itr;
+				}
+			}
+		}
+	};
+
+	thread_buffer& local_buffer()
+	{
+		thread_local thread_holder holder;
+		return *holder.buffer;
+	}
+
+	void write_escaped(std::ostream& stream, const char* text)
+	{
+		for (; *text != '\0'; text++) {
+			char chr = *text;
+			if ((chr == '"') || (chr == '\\')) {
+				stream << '\\' << chr;
+			} else if (static_cast<unsigned char>(chr) < 0x20) {
+				stream << ' ';
+			} else {
+				stream << chr;
+			}
+		}
+	}
+} // namespace
+
+void streamfx::util::trace::record(const char* name, std::chrono::high_resolution_clock::time_point start,
+								   std::chrono::high_resolution_clock::time_point end)
+{
+	auto& epoch = registry::instance().epoch;
+	auto& buf   = local_buffer();
+
+	// Only the owning thread ever writes, so the slot can be claimed without any atomic read-modify-write.
+	uint64_t idx = buf.head.load(std::memory_order_relaxed);
+	auto&    ev  = buf.events[idx & (event_capacity - 1)];
+	ev.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	std::array<uint64_t, name_words> words{};
+	strncpy(reinterpret_cast<char*>(words.data()), name ? name : "", name_length - 1);
+	ev.start.store(std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch).count(), 0),
+				   std::memory_order_relaxed);
+	ev.duration.store(std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(), 0),
+					  std::memory_order_relaxed);
+	for (size_t idx = 0; idx < name_words; idx++) {
+		ev.name[idx].store(words[idx], std::memory_order_relaxed);
+	}
+
+	ev.sequence.store(idx + 1, std::memory_order_release);
+	buf.head.store(idx + 1, std::memory_order_release);
+}
+
+void streamfx::util::trace::set_thread_name(const char* name)
+{
+	auto& buf = local_buffer();
+
+	std::lock_guard<std::mutex> lg(registry::instance().lock);
+	buf.name = name;
+}
+
+bool streamfx::util::trace::dump(const std::filesystem::path& path)
+{
+	struct copied_event {
+		int64_t                          start;
+		int64_t                          duration;
+		std::array<uint64_t, name_words> name;
+	};
+
+	std::list<std::pair<std::shared_ptr<thread_buffer>, std::string>> buffers;
+	{
+		auto&                       reg = registry::instance();
+		std::lock_guard<std::mutex> lg(reg.lock);
+		for (auto& buf : reg.buffers) {
+			buffers.emplace_back(buf, buf->name);
+		}
+	}
+
+	std::ofstream stream(path, std::ios::out | std::ios::trunc);
+	if (!stream.is_open()) {
+		D_LOG_ERROR("Failed to open '%s' for writing.", path.u8string().c_str());
+		return false;
+	}
+
+	size_t total = 0;
+	stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+	for (auto& kv : buffers) {
+		auto& buf = *kv.first;
+
+		stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buf.id
+			   << ",\"args\":{\"name\":\"";
+		write_escaped(stream, kv.second.c_str());
+		stream << "\"}}";
+		first = false;
+
+		// Copy each event out and only keep it if it was not overwritten while copying.
+		uint64_t head = buf.head.load(std::memory_order_acquire);
+		for (uint64_t idx = (head > event_capacity) ? (head - event_capacity) : 0; idx < head; idx++) {
+			auto&        ev = buf.events[idx & (event_capacity - 1)];
+			copied_event copy;
+
+			if (ev.sequence.load(std::memory_order_acquire) != (idx + 1)) {
+				continue;
+			}
+			copy.start    = ev.start.load(std::memory_order_relaxed);
+			copy.duration = ev.duration.load(std::memory_order_relaxed);
+			for (size_t ndx = 0; ndx < name_words; ndx++) {
+				copy.name[ndx] = ev.name[ndx].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (ev.sequence.load(std::memory_order_relaxed) != (idx + 1)) {
+				continue;
+			}
+			reinterpret_cast<char*>(copy.name.data())[name_length - 1] = '\0';
+
+			stream << ",\n{\"name\":\"";
+			write_escaped(stream, reinterpret_cast<const char*>(copy.name.data()));
+			stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buf.id << ",\"ts\":" << (copy.start / 1000) << "."
+				   << std::setfill('0') << std::setw(3) << (copy.start % 1000) << ",\"dur\":" << (copy.duration / 1000)
+				   << "." << std::setw(3) << (copy.duration % 1000) << std::setfill(' ') << "}";
+			total++;
+		}
+	}
+	stream << "\n]}\n";
+
+	if (!stream.good()) {
+		D_LOG_ERROR("Failed to write trace to '%s'.", path.u8string().c_str());
+		return false;
+	}
+
+	D_LOG_INFO("Wrote %zu events from %zu threads to '%s'.", total, buffers.size(), path.u8string().c_str());
+	return true;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2022 Michael Fabian Dirks
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#pragma once
+#include "warning-disable.hpp"
+#include <chrono>
+#include <filesystem>
+#include "warning-enable.hpp"
+
+namespace streamfx::util::trace {
+	/** Record a complete event on the calling thread.
+	 *
+	 * Events go into a fixed size ring buffer owned by the calling thread, so recording never blocks and never
+	 * allocates after the first event of a thread. Once the buffer is full, the oldest events are overwritten.
+	 *
+	 * @param name Name of the event, truncated to fit the event.
+	 * @param start Time at which the event started.
+	 * @param end Time at which the event ended.
+	 */
+	void record(const char* name, std::chrono::high_resolution_clock::time_point start,
+				std::chrono::high_resolution_clock::time_point end);
+
+	/** Set the name under which the calling thread shows up in the trace.
+	 */
+	void set_thread_name(const char* name);
+
+	/** Write all currently recorded events of all threads to a Chrome Trace Event JSON file.
+	 *
+	 * The result can be loaded into chrome://tracing or Perfetto.
+	 *
+	 * @return true if the file was written, otherwise false.
+	 */
+	bool dump(const std::filesystem::path& path);
+
+	class scope {
+		const char*                                    _name;
+		std::chrono::high_resolution_clock::time_point _start;
+
+		public:
+		inline scope(const char* name) : _name(name), _start(std::chrono::high_resolution_clock::now()) {}
+
+		inline ~scope()
+		{
+			record(_name, _start, std::chrono::high_resolution_clock::now());
+		}
+	};
+} // namespace streamfx::util::trace